@@ -6,10 +6,10 @@
 
 namespace fty::asset {
 
-Expected<void> sendConfigure(
-    const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows, const std::string& agentName);
+/// Enqueues asset notifications to the asset publisher, returns without waiting for them to be sent
+Expected<void> sendConfigure(const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows);
 
-Expected<void> sendConfigure(const db::AssetElement& row, persist::asset_operation actionType, const std::string& agentName);
+Expected<void> sendConfigure(const db::AssetElement& row, persist::asset_operation actionType);
 
 std::string generateMlmClientId(const std::string& client_name);
 
@@ -1,4 +1,5 @@
 #pragma once
+#include "asset-names.h"
 #include <fty/expected.h>
 #include <functional>
 #include <map>
@@ -55,6 +56,14 @@ struct AssetLink
     uint16_t    type;   //!< link type id
 };
 
+struct AssetExtAttribute
+{
+    uint32_t    elementId = 0;
+    std::string keytag;
+    std::string value;
+    bool        readOnly = false;
+};
+
 struct ExtAttrValue
 {
     std::string value;
@@ -85,6 +94,12 @@ Expected<int64_t> nameToAssetId(const std::string& assetName); //!test
 /// @return pair of name and extended name or error
 Expected<std::pair<std::string, std::string>> idToNameExtName(uint32_t assetId); //!test
 
+/// Converts database ids to internal names and extended (unicode) names using a single query
+/// @param assetIds list of asset ids
+/// @return map of id to pair of name and extended name (unknown ids are not in the map) or error
+Expected<std::map<uint32_t, std::pair<std::string, std::string>>> idToNameExtName(
+    const std::vector<uint32_t>& assetIds); //!test
+
 /// Converts asset's extended name to its internal name
 /// @param assetExtName asset external name
 /// @return internal name or error
@@ -95,11 +110,21 @@ Expected<std::string> extNameToAssetName(const std::string& assetExtName); //!te
 /// @return external name or error
 Expected<std::string> nameToExtName(std::string assetName);
 
+/// Converts internal names to extended names using a single query
+/// @param assetNames list of asset internal names
+/// @return map of internal name to extended name (unknown names are not in the map) or error
+Expected<std::map<std::string, std::string>> nameToExtName(const std::vector<std::string>& assetNames); //!test
+
 /// Converts asset's extended name to id
 /// @param assetExtName asset external name
 /// @return id or error
 Expected<int64_t> extNameToAssetId(const std::string& assetExtName); //!test
 
+/// Resolves names, each of them can be internal or extended name, using batched queries
+/// @param names list of asset internal or extended names
+/// @return identities of assets matching any of the names by internal or extended name or error
+Expected<std::vector<NameIndex::Entry>> resolveAssetNames(const std::vector<std::string>& names); //!test
+
 /// select basic information about asset element by name
 /// @param name asset internal or external name
 /// @return @ref AssetElement or error
@@ -153,6 +178,12 @@ Expected<uint> deleteAssetExtAttributesWithRo(tnt::Connection& conn, uint32_t el
 Expected<uint> insertIntoAssetExtAttributes(
     tnt::Connection& conn, uint32_t elementId, const std::map<std::string, std::string>& attributes, bool readOnly); //!test
 
+/// Inserts ext attributes of any number of assets into t_bios_asset_ext_attributes using multi-row statements
+/// @param conn database established connection
+/// @param attributes attributes to insert
+/// @return affected rows count or error
+Expected<uint> insertIntoAssetExtAttributes(tnt::Connection& conn, const std::vector<AssetExtAttribute>& attributes); //!test
+
 /// Delete asset from all group
 /// @param conn database established connection
 /// @param elementId asset element id to delete
@@ -173,6 +204,13 @@ Expected<uint32_t> insertIntoAssetElement(tnt::Connection& conn, const AssetElem
 /// @return count of affected rows or error
 Expected<uint> insertElementIntoGroups(tnt::Connection& conn, const std::set<uint32_t>& groups, uint32_t elementId); //!test
 
+/// Inserts any number of assets into groups using multi-row statements
+/// @param conn database established connection
+/// @param relations list of pairs of element id and group id
+/// @return count of affected rows (all the relations were inserted) or error
+Expected<uint> insertElementsIntoGroups(
+    tnt::Connection& conn, const std::vector<std::pair<uint32_t, uint32_t>>& relations); //!test
+
 /// Deletes all links which have given asset as 'dest'
 /// @param conn database established connection
 /// @param elementId element id
@@ -191,6 +229,21 @@ Expected<int64_t> insertIntoAssetLink(tnt::Connection& conn, const AssetLink& li
 /// @return count of inserted links or error
 Expected<uint> insertIntoAssetLinks(tnt::Connection& conn, const std::vector<AssetLink>& links); //! test
 
+/// Outcome of one link of @ref insertAssetLinks
+enum class LinkOutcome
+{
+    Inserted, //!< link was inserted
+    Skipped,  //!< the same link already exists (or is given twice) or source/destination is not a device
+    Invalid   //!< source or destination is not specified or wrong link type
+};
+
+/// Inserts powerlinks of any number of devices, one set based statement per batch of links, with the same
+/// duplicate protection as @ref insertIntoAssetLink
+/// @param conn database established connection
+/// @param links list of powerlink info
+/// @return outcome of every link, in the order of given links, or error
+Expected<std::vector<LinkOutcome>> insertAssetLinks(tnt::Connection& conn, const std::vector<AssetLink>& links); //! test
+
 /// Inserts name<->device_type relation
 /// @param conn database established connection
 /// @param deviceTypeId device type
@@ -280,6 +333,59 @@ Expected<std::vector<uint32_t>> selectAssetsByParent(uint32_t parentId);
 /// @return list of devices where element is linked or error
 Expected<std::vector<uint32_t>> selectAssetDeviceLinksSrc(uint32_t elementId); //! test
 
+/// Selects all data about given assets in WebAssetElement, unknown ids are skipped
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return list of elements or error
+Expected<std::vector<WebAssetElement>> selectAssetElementsWebByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
+
+/// Selects all corresponding links for given elements
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return map of element id to list of devices where element is linked or error
+Expected<std::map<uint32_t, std::vector<uint32_t>>> selectAssetDeviceLinksSrc(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
+
+/// Selects assets which have given keytag set to one of the values in t_bios_asset_ext_attributes
+/// @param conn database established connection
+/// @param keytag keytag
+/// @param values values (asset names)
+/// @return map of value to ids of assets referring to it or error
+Expected<std::map<std::string, std::vector<uint32_t>>> selectKeytagOwners(
+    tnt::Connection& conn, const std::string& keytag, const std::vector<std::string>& values); //! test
+
+/// Counts assets of given type
+/// @param conn database established connection
+/// @param typeId asset type id
+/// @return count or error
+Expected<uint32_t> countAssetsByType(tnt::Connection& conn, uint16_t typeId);
+
+/// Deletes group relations of given assets, as members and as groups
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return count of affected rows or error
+Expected<uint> deleteAssetGroupRelations(tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
+
+/// Deletes links of given assets, as sources and as destinations
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return count of affected rows or error
+Expected<uint> deleteAssetLinks(tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
+
+/// Deletes given assets from t_bios_monitor_asset_relation
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return count of affected rows or error
+Expected<uint> deleteMonitorAssetRelations(tnt::Connection& conn, const std::vector<uint32_t>& ids);
+
+/// Deletes assets from t_bios_asset_element. Ids must not contain a parent of another id: callers which delete nested
+/// assets call it once per layer, children first
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return count of affected rows or error
+Expected<uint> deleteAssetElements(tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
+
 Expected<std::map<std::string, int>> readElementTypes();
 Expected<std::map<std::string, int>> readDeviceTypes();
 
@@ -287,21 +393,85 @@ Expected<std::map<std::string, int>> readDeviceTypes();
 /// @return  number of power sources or error
 Expected<uint32_t> maxNumberOfPowerLinks();
 
+/// Selects maximum number of power sources for device in the system
+/// @param conn database established connection
+/// @return  number of power sources or error
+Expected<uint32_t> maxNumberOfPowerLinks(tnt::Connection& conn);
+
 /// Selects maximal number of groups in the system
 /// @return number of groups or error
 Expected<uint32_t> maxNumberOfAssetGroups();
 
+/// Selects maximal number of groups in the system
+/// @param conn database established connection
+/// @return number of groups or error
+Expected<uint32_t> maxNumberOfAssetGroups(tnt::Connection& conn);
+
 /// Selects all read-write ext attributes
 /// @return attribures names or error
 Expected<std::vector<std::string>> selectExtRwAttributesKeytags();
 
+/// Selects all read-write ext attributes
+/// @param conn database established connection
+/// @return attribures names or error
+Expected<std::vector<std::string>> selectExtRwAttributesKeytags(tnt::Connection& conn);
+
 /// Selects everything from v_web_element
 /// @param dc datacenter id, if is set then returns assets for datacenter only
 /// @return list of elements or error
 Expected<std::vector<WebAssetElement>> selectAssetElementAll(const std::optional<uint32_t>& dc = std::nullopt);
 
+/// Selects everything from v_web_element
+/// @param conn database established connection
+/// @param dc datacenter id, if is set then returns assets for datacenter only
+/// @return list of elements or error
+Expected<std::vector<WebAssetElement>> selectAssetElementAll(
+    tnt::Connection& conn, const std::optional<uint32_t>& dc = std::nullopt); //! test
+
+/// Streams everything from v_web_element, rows are fetched by chunks and never held in memory together
+/// @param conn database established connection
+/// @param dc datacenter id, if is set then returns assets for datacenter only
+/// @param callback called for each element, returns false to stop the iteration
+/// @return nothing or error
+Expected<void> selectAssetElementAll(tnt::Connection& conn, const std::optional<uint32_t>& dc,
+    const std::function<bool(const WebAssetElement&)>& callback);
+
 /// Selects all group names for given element id
 /// @param id asset element id
 /// @return group names or error
 Expected<std::vector<std::string>> selectGroupNames(uint32_t id);
+
+// =====================================================================================================================
+// Bulk selects, fetch data of many assets in one query
+// =====================================================================================================================
+
+/// Selects a page of v_web_element, ordered by id, for the callers which walk all assets without holding them
+/// @param conn database established connection
+/// @param afterId id of the last element of previous page, 0 for the first page
+/// @param limit maximum number of elements in the page
+/// @return list of elements or error, the list is empty after the last page
+Expected<std::vector<WebAssetElement>> selectAssetElementPage(
+    tnt::Connection& conn, uint32_t afterId, size_t limit); //! test
+
+/// Selects ext attributes of given assets
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return map of asset id to its attributes or error
+Expected<std::map<uint32_t, Attributes>> selectExtAttributesByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
+
+/// Selects links of given type which have one of given devices as 'dest'
+/// @param conn database established connection
+/// @param ids dest device ids
+/// @param linkTypeId link type id
+/// @return map of dest device id to its links (in order of creation) or error
+Expected<std::map<uint32_t, std::vector<DbAssetLink>>> selectAssetDeviceLinksToByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids, uint8_t linkTypeId); //! test
+
+/// Selects groups of given assets
+/// @param conn database established connection
+/// @param ids asset element ids
+/// @return map of asset id to ids of groups it belongs to (in order of assignment) or error
+Expected<std::map<uint32_t, std::vector<uint32_t>>> selectAssetGroupsByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids); //! test
 } // namespace fty::asset::db
@@ -0,0 +1,63 @@
+#pragma once
+#include "asset/error.h"
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace fty::asset {
+
+// =====================================================================================================================
+
+/// Orders a list of assets for deletion.
+///
+/// Candidates are indexed by id. Dependencies say that an asset can be deleted only together with, and after, another
+/// one: a parent after its children, a power source after the devices it powers, an asset after the sensors which
+/// refer to it as their logical asset. The plan propagates failures along the dependencies and orders the rest with
+/// Kahn's algorithm into layers; every layer can be deleted by one set based statement. Assets caught in a cycle
+/// cannot be ordered and fail.
+class DeletePlan
+{
+public:
+    using Layers = std::vector<std::vector<uint32_t>>;
+
+public:
+    /// Adds asset requested for deletion, all candidates must be added before dependencies
+    void addCandidate(uint32_t id);
+
+    /// Says that an asset can be deleted only after the blocker, fails if the blocker is not a candidate
+    /// @param id asset element id
+    /// @param blocker asset which must be deleted first
+    /// @param reason error reported if the blocker is not or cannot be deleted
+    void require(uint32_t id, uint32_t blocker, const Translate& reason);
+
+    /// Marks asset as not deletable, all assets which depend on it fail as well
+    void fail(uint32_t id, const Translate& reason);
+
+    /// Propagates failures and orders deletable assets, can be called again after more failures
+    void build();
+
+    bool             isCandidate(uint32_t id) const;
+    bool             isDeletable(uint32_t id) const;
+    const Layers&    layers() const;
+    const Translate* failure(uint32_t id) const;
+
+private:
+    struct Candidate
+    {
+        // Assets which can be deleted only after this one, with the reason to report
+        std::vector<std::pair<uint32_t, Translate>> dependents;
+    };
+
+    void propagate(uint32_t id, const Translate& reason);
+
+private:
+    std::unordered_map<uint32_t, Candidate>     m_candidates;
+    std::vector<uint32_t>                       m_order;
+    std::vector<std::pair<uint32_t, Translate>> m_failures;
+    std::map<uint32_t, Translate>               m_failed;
+    Layers                                      m_layers;
+};
+
+// =====================================================================================================================
+
+} // namespace fty::asset
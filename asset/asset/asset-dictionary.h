@@ -0,0 +1,65 @@
+#pragma once
+#include "error.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace fty::asset::db {
+
+// =====================================================================================================================
+
+/// Process-wide cache of the type dictionaries (element types and device types).
+///
+/// Dictionaries are loaded once into an immutable snapshot, which is shared by everyone who asks for it and stays
+/// valid as long as somebody holds it. The snapshot is keyed by a version (count and checksum of the dictionary
+/// tables), which is rechecked at most once per FTY_ASSET_DICTIONARY_TTL seconds (0 checks it for every request); the
+/// dictionaries are reloaded only if the version changed.
+class Dictionary
+{
+public:
+    struct Snapshot
+    {
+        std::string                version;
+        std::map<std::string, int> types;
+        std::map<std::string, int> subtypes;
+
+        /// Returns id of element type
+        std::optional<uint16_t> typeId(const std::string& name) const;
+
+        /// Returns id of device type, accepts aliases of the rack controller and patch panel as well
+        std::optional<uint16_t> subtypeId(const std::string& name) const;
+
+    private:
+        friend class Dictionary;
+        std::map<std::string, int> aliases;
+    };
+
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+public:
+    static Dictionary& instance();
+
+    /// Returns actual snapshot of the dictionaries, loads them if they changed
+    Expected<SnapshotPtr> snapshot();
+
+    /// Drops the snapshot, next request reloads it
+    void invalidate();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Dictionary();
+
+private:
+    std::mutex                       m_mutex;
+    SnapshotPtr                      m_snapshot;
+    std::optional<Clock::time_point> m_checked;
+    std::chrono::seconds             m_ttl;
+};
+
+// =====================================================================================================================
+
+} // namespace fty::asset::db
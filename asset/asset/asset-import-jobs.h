@@ -0,0 +1,158 @@
+#pragma once
+#include "asset-manager.h"
+#include "csv.h"
+#include "error.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fty::asset {
+
+class Import;
+
+// =====================================================================================================================
+
+/// CSV document imported in parts of rows (FTY_ASSET_IMPORT_PART), one part per call of next().
+///
+/// Parts are imported within the budget of the import: rows over FTY_ASSET_IMPORT_MAX_ROWS, or read after
+/// FTY_ASSET_IMPORT_MAX_TIME seconds, are not imported and the first of them is reported as failed.
+class CsvImport
+{
+public:
+    /// Import of the document read from the stream
+    CsvImport(std::istream& in, const std::string& user, bool sendNotify = true);
+    /// Import of the document read in place, which must outlive the import
+    CsvImport(std::string_view document, const std::string& user, bool sendNotify = true);
+    ~CsvImport();
+
+    CsvImport(const CsvImport&) = delete;
+    CsvImport& operator=(const CsvImport&) = delete;
+
+    /// Imports next part of the document
+    /// @return false once the document is imported, the import failed, its budget is over or it was cancelled
+    bool next();
+
+    /// Stops the import between rows once the predicate returns true
+    void setCancel(std::function<bool()> cancelled);
+
+    /// Validates the rows without writing anything, see Import::setDryRun
+    void setDryRun(bool dryRun);
+
+    /// Failure of the whole import (invalid document, licensing...), valid once next() returned false. The parts
+    /// imported before stay imported, the first row which was not is reported as failed with the failure.
+    const AssetExpected<void>& status() const;
+
+    /// Results of the imported rows, by line of the document
+    const AssetManager::ImportList& items() const;
+
+    /// Count of rows imported and failed so far, can be read by other threads
+    size_t rowsDone() const;
+    size_t rowsFailed() const;
+
+private:
+    void importPart(CsvMap&& part);
+    void stop(const std::string& reason, size_t row = 1);
+    void finish();
+
+private:
+    std::unique_ptr<std::streambuf>       m_buf;
+    std::unique_ptr<std::istream>         m_stream;
+    std::istream&                         m_in;
+    std::string                           m_user;
+    bool                                  m_sendNotify;
+    std::function<bool()>                 m_cancelled;
+    bool                                  m_dryRun = false;
+    std::chrono::steady_clock::time_point m_started;
+    std::optional<CsvReader>              m_reader;
+    bool                                  m_finished = false;
+    AssetExpected<void>                   m_status;
+    AssetManager::ImportList              m_items;
+    std::atomic<size_t>                   m_done{0};
+    std::atomic<size_t>                   m_failed{0};
+
+    // Every part is imported on its own, the import of the previous one is kept until the next part continues it
+    std::unique_ptr<CsvMap> m_csv;
+    std::unique_ptr<Import> m_import;
+    size_t                  m_offset = 0;
+};
+
+// =====================================================================================================================
+
+/// CSV imports running in the background.
+///
+/// Jobs are queued and imported by FTY_ASSET_IMPORT_JOBS threads part by part: a job goes back to the end of the queue
+/// after every part, so a big document does not hold back the smaller ones. At most FTY_ASSET_IMPORT_MAX_JOBS jobs are
+/// queued or running at once. Finished jobs keep only the results of their rows, for FTY_ASSET_IMPORT_JOB_TTL seconds.
+class ImportJobs
+{
+public:
+    enum class State
+    {
+        Queued,
+        Running,
+        Finished,
+        Cancelled,
+        Failed
+    };
+
+    struct Status
+    {
+        State                                   state         = State::Queued;
+        size_t                                  rowsDone      = 0;
+        size_t                                  rowsFailed    = 0;
+        double                                  rowsPerSecond = 0;
+        std::optional<AssetManager::ImportList> items; //!< results of the rows, once the job is over
+        std::optional<Translate>                error; //!< failure of the whole import
+    };
+
+public:
+    static ImportJobs& instance();
+    ~ImportJobs();
+
+    /// Queues import of the document
+    /// @return id of the job, error if too many jobs are queued or running
+    Expected<std::string> submit(std::string&& csv, const std::string& user, bool sendNotify = true);
+
+    /// Status of the job, nothing if the job is not known
+    std::optional<Status> status(const std::string& id) const;
+
+    /// Cancels the job between rows, the rows imported so far stay imported
+    /// @return false if the job is not known
+    bool cancel(const std::string& id);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job;
+
+    ImportJobs();
+
+    void run();
+    void expire();
+
+private:
+    mutable std::mutex                          m_mutex;
+    std::condition_variable                     m_cond;
+    std::map<std::string, std::shared_ptr<Job>> m_jobs;
+    std::deque<std::shared_ptr<Job>>            m_queue;
+    std::vector<std::thread>                    m_threads;
+    bool                                        m_stop   = false;
+    uint64_t                                    m_lastId = 0;
+    std::chrono::seconds                        m_ttl;
+    size_t                                      m_maxJobs;
+};
+
+// =====================================================================================================================
+
+} // namespace fty::asset
@@ -1,8 +1,14 @@
 #pragma once
 #include "asset-db.h"
+#include "asset-dictionary.h"
+#include "asset-topology.h"
+#include "csv.h"
 #include "error.h"
 #include <fty_common_asset_types.h>
+#include <functional>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 
 namespace tntdb {
@@ -10,7 +16,6 @@ class Connection;
 }
 
 namespace fty::asset {
-class CsvMap;
 
 namespace db {
     struct AssetLink;
@@ -26,15 +31,122 @@ public:
     const ImportResMap&      items() const;
     persist::asset_operation operation() const;
 
+    /// Writes given count of rows in one transaction (bulk mode), 1 (default) writes every row in its own transaction
+    void setChunkSize(size_t rows);
+
+    /// Processes independent groups of rows (rows which don't refer to each other) on given count of threads, every
+    /// group in file order; 1 (default) processes all the rows in file order. Groups are written by their own
+    /// transactions, which share only the assets existing before the import (locations, power sources, groups).
+    void setWorkers(size_t workers);
+
+    /// Continues the import of a document read in several parts: the rows of this part follow the rows of the previous
+    /// one. Detection of rackcontroller-0 and of the elements written twice take the previous parts into account.
+    void continues(const Import& previous);
+
+    /// Validates the rows without writing anything (no write transaction is opened): names, types and locations are
+    /// checked against the assets known before the import, the elements created by the rows exist only in memory
+    void setDryRun(bool dryRun);
+
+    /// Stops processing of the rows once the predicate returns true, the rows which were not processed have no result
+    void setCancel(std::function<bool()> cancelled);
+
 private:
+    struct Chunk;
+
+    struct ResolvedName
+    {
+        uint32_t    id = 0;
+        std::string name;
+    };
+
+    // Names are compared by the database case insensitively
+    struct CaseLess
+    {
+        bool operator()(const std::string& l, const std::string& r) const;
+    };
+
+    // Columns of the document, resolved once
+    struct Columns
+    {
+        struct Power
+        {
+            CsvMap::Column                source;
+            std::optional<CsvMap::Column> plug;
+            std::optional<CsvMap::Column> input;
+        };
+
+        std::optional<CsvMap::Column>                       id;
+        CsvMap::Column                                      name;
+        CsvMap::Column                                      type;
+        CsvMap::Column                                      subtype;
+        CsvMap::Column                                      location;
+        CsvMap::Column                                      status;
+        CsvMap::Column                                      priority;
+        std::optional<CsvMap::Column>                       assetTag;
+        std::vector<CsvMap::Column>                         groups; // group.1 ... group.N
+        std::vector<Power>                                  powers; // power_source.1 ... power_source.N
+        std::vector<std::pair<std::string, CsvMap::Column>> ext;    // columns stored as ext attributes
+        std::set<std::string>                               hardware; // not stored for rackcontroller-0
+    };
+
+    using NameMap = std::map<std::string, ResolvedName, CaseLess>;
+    using RowIt   = std::vector<size_t>::const_iterator;
+
+    // Assets referenced by the document by their names and extended names. Names of a group of rows (parallel mode)
+    // hide the names resolved before, removed names are kept there with id 0 and empty extended names.
+    struct Names
+    {
+        NameMap                         byName;
+        NameMap                         byExtName;
+        std::map<uint32_t, std::string> extNames;
+    };
+
     std::string                        mandatoryMissing() const;
-    std::map<std::string, std::string> sanitizeRowExtNames(size_t row, bool sanitize) const;
+    void                               resolveColumns();
+    Expected<void>                     resolveNames();
+    void                               rememberName(const db::AssetElement& el, const std::string& extName);
+    void                               forgetName(uint32_t id, const std::string& name, const std::string& extName);
+    const ResolvedName*                findName(const std::string& name, bool ext) const;
+    std::optional<std::string>         findExtName(uint32_t id) const;
+    void                               dropName(const std::string& name, bool ext);
+    void                               mergeNames(Names&& names);
+    Expected<uint32_t>                 nameToAssetId(const std::string& name) const;
+    Expected<std::string>              extNameToAssetName(const std::string& extName) const;
+    Expected<uint32_t>                 assetIdByName(const std::string& name) const;
+    std::string sanitizedName(const CsvMap::RowView& cells, CsvMap::Column col, bool sanitize) const;
     AssetExpected<db::AssetElement>    processRow(size_t row, const std::set<uint32_t>& ids, bool sanitize, bool checkLic);
     uint16_t                           getPriority(const std::string& s) const;
     bool                               isDate(const std::string& key) const;
     std::string                        matchExtAttr(const std::string& value, const std::string& key) const;
     bool                               checkUSize(const std::string& s) const;
 
+    bool                             cancelled() const;
+    std::vector<std::vector<size_t>> independentRows() const;
+    void                             processParallel(bool checkLic);
+    void                             processRows(const std::vector<size_t>& rows, bool checkLic);
+
+    void           recordRow(size_t row, AssetExpected<db::AssetElement>&& el, std::set<uint32_t>& ids);
+    void           processChunk(RowIt first, RowIt last, std::set<uint32_t>& ids, bool checkLic);
+    Expected<void> flushChunk();
+    void           activateAll(std::vector<std::pair<size_t, uint32_t>>&& activations);
+    void           setOperation(size_t row, persist::asset_operation operation);
+
+    template <typename Func>
+    auto writeRow(Func&& func);
+
+    void                nameChanged(uint32_t elementId) const;
+    AssetExpected<void> activate(size_t row, uint32_t elementId);
+
+    static AssetExpected<void> activateDevice(uint32_t elementId);
+
+    Expected<void> insertExtAttributes(tnt::Connection& conn, uint32_t elementId,
+        const std::map<std::string, std::string>& attributes, bool readOnly) const;
+    Expected<void> insertGroups(tnt::Connection& conn, const std::set<uint32_t>& groups, uint32_t elementId) const;
+    Expected<void> insertLinks(tnt::Connection& conn, const std::vector<db::AssetLink>& links) const;
+
+    AssetExpected<void> checkWrite(
+        uint32_t elementId, const std::string& elementName, uint16_t typeId, const std::string& status) const;
+
     AssetExpected<void> updateDcRoomRowRackGroup(tnt::Connection& conn, uint32_t elementId,
         const std::string& elementName, uint32_t parentId, const std::map<std::string, std::string>& extattributes,
         const std::string& status, uint16_t priority, const std::set<uint32_t>& groups, const std::string& assetTag,
@@ -57,9 +169,40 @@ private:
         const std::map<std::string, std::string>& extattributesRO) const;
 
 private:
-    const CsvMap&            m_cm;
-    ImportResMap             m_el;
-    persist::asset_operation m_operation;
+    const CsvMap&               m_cm;
+    Columns                     m_columns;
+    ImportResMap                m_el;
+    db::Dictionary::SnapshotPtr m_dictionary;
+
+    size_t                m_chunkSize = 1;
+    size_t                m_workers   = 1;
+    std::function<bool()> m_cancelled;
+    bool                  m_dryRun   = false;
+    uint32_t              m_dryRunId = std::numeric_limits<uint32_t>::max();
+
+    // Row of rackcontroller-0 (first row of the document) or -1, 0 if it was in a previous part
+    std::optional<int> m_rc0Row;
+    // Elements written by the previous parts of the document
+    std::set<uint32_t> m_written;
+    // Assets updated by the rows (id column), read with the names for the dry run
+    std::map<uint32_t, db::Topology::Node> m_idNodes;
+
+    // Chunk written by the calling thread (bulk mode)
+    static thread_local Chunk* m_chunk;
+    // Names of the group of rows processed by the calling thread (parallel mode)
+    static thread_local Names* m_groupNames;
+
+    // Guards the results, the operations and the activations below while the rows are processed by several threads
+    mutable std::mutex                         m_mutex;
+    std::map<size_t, persist::asset_operation> m_operations;
+
+    // Devices to activate once all the rows are written (parallel mode), so the licensing sees them in file order
+    std::vector<std::pair<size_t, uint32_t>> m_activations;
+
+    // Assets referenced by the document, resolved before the rows are processed, and the assets written by the rows.
+    // The rows processed by several threads don't change them: every group of rows has its own names, which are merged
+    // once all the groups are processed, so the threads never see the (uncommitted) names of the other groups.
+    Names m_names;
 };
 
 } // namespace fty::asset
@@ -1,5 +1,12 @@
 #pragma once
 #include "error.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
 
 namespace fty::asset {
 
@@ -9,8 +16,65 @@ struct LimitationsStruct
     int global_configurability;
 };
 
-AssetExpected<LimitationsStruct> getLicensingLimitation();
+// =====================================================================================================================
 
-}
+/// Process-wide cache of the licensing limitations.
+///
+/// Limitations are queried from etn-licensing by a background thread, every FTY_ASSET_LICENSING_TTL seconds. Changes
+/// announced on the licensing announcements stream are applied to the cached limitations at once. Callers get the
+/// cached limitations and wait for the agent only while nothing was fetched yet. FTY_ASSET_LICENSING_TTL=0 disables
+/// the cache.
+class Licensing
+{
+public:
+    using Query = std::function<AssetExpected<LimitationsStruct>()>;
+
+public:
+    static Licensing& instance();
+
+    /// Cache of the limitations returned by the query, refreshed every ttl (0 queries at every call)
+    /// @param announcements listens to the licensing announcements stream
+    Licensing(Query query, std::chrono::seconds ttl, bool announcements = false);
+    ~Licensing();
+
+    /// Returns cached limitations, waits for the first query
+    AssetExpected<LimitationsStruct> limitations();
+
+    /// Queries the limitations again, the cached ones are returned meanwhile
+    void invalidate();
+
+    /// Applies the limitation announced by the agent (metric of rackcontroller-0) to the cached ones, unknown
+    /// limitations are queried again
+    void announced(const std::string& asset, const std::string& type, const std::string& value);
 
+    /// Stops the thread
+    void stop();
 
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    bool refreshNeeded() const;
+
+private:
+    Query                            m_query;
+    bool                             m_announcements;
+    std::mutex                       m_mutex;
+    std::condition_variable          m_cond;
+    std::optional<LimitationsStruct> m_cached;
+    std::optional<Translate>         m_error;
+    std::optional<Clock::time_point> m_queried;
+    uint64_t                         m_queries = 0;
+    bool                             m_refresh  = true;
+    bool                             m_querying = false;
+    bool                             m_stopped = false;
+    std::chrono::seconds             m_ttl;
+    std::thread                      m_thread;
+};
+
+// =====================================================================================================================
+
+/// Returns licensing limitations, see Licensing
+AssetExpected<LimitationsStruct> getLicensingLimitation();
+
+}
@@ -25,8 +25,21 @@ public:
     static AssetExpected<db::AssetElement>                        deleteAsset(const db::AssetElement& element);
 
     static AssetExpected<uint32_t> createAsset(const std::string& json, const std::string& user, bool sendNotify = true);
+    /// Imports the document in parts of rows. Failure of the import (licensing, internal error...) is returned as error
+    /// only if no row was processed, otherwise the results of the processed rows, which stay written, are returned and
+    /// the first row which was not processed is reported as failed with the failure
     static AssetExpected<ImportList> importCsv(const std::string& csv, const std::string& user, bool sendNotify = true);
+    /// Imports the document read from the stream in parts of rows, so the memory used does not depend on its size.
+    /// Rows over the row or time budget of the import are not imported, the first of them is reported as failed
+    static AssetExpected<ImportList> importCsv(std::istream& csv, const std::string& user, bool sendNotify = true);
+    /// Validates the document as importCsv does, without writing anything. Rows which would create an asset get an
+    /// id which does not exist in the database
+    static AssetExpected<ImportList> validateCsv(
+        const std::string& csv, const std::string& user, bool sendNotify = true);
     static AssetExpected<std::string> exportCsv(const std::optional<db::AssetElement>& dc = std::nullopt);
+    /// Writes export into the stream row by row, as elements are fetched from database. Nothing is written before
+    /// the data joined to the elements is selected
+    static AssetExpected<void> exportCsv(std::ostream& out, const std::optional<db::AssetElement>& dc = std::nullopt);
 private:
     static AssetExpected<db::AssetElement> deleteDcRoomRowRack(const db::AssetElement& element);
     static AssetExpected<db::AssetElement> deleteGroup(const db::AssetElement& element);
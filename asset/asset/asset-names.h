@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace fty::asset::db {
+
+// =====================================================================================================================
+
+/// Process-wide index of asset identities: database id, internal name and extended (unicode) name.
+///
+/// The index is filled lazily by the name conversion functions of asset-db.h and resolves every direction in O(1).
+/// Write paths which can change one of the identities (insert/delete of elements, rewrite of ext attributes) erase
+/// the affected entry. Entries are stamped with a generation, so a lookup which raced with a write never stores stale
+/// data. As other processes can write to the database as well, entries also expire after a configurable time
+/// (FTY_ASSET_NAME_INDEX_TTL, seconds, 0 disables the index).
+class NameIndex
+{
+public:
+    struct Entry
+    {
+        uint32_t                   id = 0;
+        std::string                name;
+        std::optional<std::string> extName;
+    };
+
+public:
+    static NameIndex& instance();
+
+    std::optional<Entry> byId(uint32_t id) const;
+    std::optional<Entry> byName(const std::string& name) const;
+    std::optional<Entry> byExtName(const std::string& extName) const;
+
+    /// Returns current generation, must be taken before database is queried
+    uint64_t generation() const;
+
+    /// Stores entry fetched from database, ignored if something was invalidated since given generation
+    /// @param entry entry to store
+    /// @param generation generation taken before the entry was selected
+    void insert(const Entry& entry, uint64_t generation);
+
+    /// Invalidates entry of given asset
+    /// @param id asset element id
+    void erase(uint32_t id);
+
+    /// Invalidates everything
+    void clear();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Record
+    {
+        Entry             entry;
+        Clock::time_point stamp;
+    };
+
+    NameIndex();
+
+    std::optional<Entry> find(const std::unordered_map<std::string, uint32_t>& index, const std::string& key) const;
+    bool                 isFresh(const Record& rec) const;
+    void                 eraseLocked(uint32_t id);
+
+private:
+    mutable std::shared_mutex                 m_mutex;
+    std::unordered_map<uint32_t, Record>      m_byId;
+    std::unordered_map<std::string, uint32_t> m_byName;
+    std::unordered_map<std::string, uint32_t> m_byExtName;
+    uint64_t                                  m_generation = 0;
+    std::chrono::seconds                      m_ttl;
+};
+
+// =====================================================================================================================
+
+} // namespace fty::asset::db
@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+typedef struct _zmsg_t zmsg_t;
+
+namespace fty::asset {
+
+// =====================================================================================================================
+
+/// Long-lived publisher of asset notifications.
+///
+/// One background thread owns the malamute client (producer on FTY_PROTO_STREAM_ASSETS). Request handlers only put
+/// encoded messages into a lock-free queue and return; the thread sends whatever is queued as one batch. Every message
+/// gets a sequence number, which is acknowledged once the message (and all the previous ones) was handed to malamute,
+/// so a caller can wait for its own notifications with waitFor() or for everything with flush().
+class Publisher
+{
+public:
+    /// Sends one message to the mailbox (empty address: to the stream), takes ownership of the message
+    /// @return false if the message was not sent
+    using Send = std::function<bool(const std::string& address, const std::string& subject, zmsg_t** msg)>;
+
+public:
+    static Publisher& instance();
+
+    /// Publisher which hands the messages to given function instead of malamute
+    explicit Publisher(Send send);
+    ~Publisher();
+
+    /// Enqueues message to the assets stream, takes ownership of the message
+    /// @param subject message subject
+    /// @param msg message to send, set to nullptr
+    /// @return sequence number of the message, 0 if publisher is stopped
+    uint64_t publish(const std::string& subject, zmsg_t** msg);
+
+    /// Enqueues message to a mailbox, takes ownership of the message
+    /// @param address mailbox address
+    /// @param subject message subject
+    /// @param msg message to send, set to nullptr
+    /// @return sequence number of the message, 0 if publisher is stopped
+    uint64_t sendTo(const std::string& address, const std::string& subject, zmsg_t** msg);
+
+    /// Waits until message with given sequence number and all the previous ones were sent
+    /// @return false on timeout
+    bool waitFor(uint64_t seq, std::chrono::milliseconds timeout);
+
+    /// Waits until everything enqueued so far was sent
+    /// @return false on timeout
+    bool flush(std::chrono::milliseconds timeout);
+
+    /// Sends what is queued and stops the thread, nothing can be enqueued anymore
+    void stop();
+
+private:
+    struct Message
+    {
+        uint64_t    seq = 0;
+        std::string address;
+        std::string subject;
+        zmsg_t*     msg = nullptr;
+    };
+
+    /// Multiple producers, single consumer queue (intrusive linked list with a stub node)
+    class Queue
+    {
+    public:
+        Queue();
+        ~Queue();
+
+        void push(Message&& msg);
+        bool pop(Message& msg);
+        bool empty() const;
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next{nullptr};
+            Message            value;
+        };
+
+        std::atomic<Node*> m_head;
+        Node*              m_tail;
+    };
+
+    Publisher();
+
+    uint64_t enqueue(const std::string& address, const std::string& subject, zmsg_t** msg);
+    void     run();
+    void     acknowledge(uint64_t seq);
+
+private:
+    Send                    m_send;
+    Queue                   m_queue;
+    std::atomic<uint64_t>   m_lastSeq{0};
+    std::atomic<bool>       m_stopped{false};
+    std::mutex              m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_acked;
+    uint64_t                m_ackedSeq = 0;
+    std::set<uint64_t>      m_sentAhead;
+    std::thread             m_thread;
+};
+
+// =====================================================================================================================
+
+} // namespace fty::asset
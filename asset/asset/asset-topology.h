@@ -0,0 +1,90 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tnt {
+class Connection;
+}
+
+namespace fty::asset::db {
+
+// =====================================================================================================================
+
+/// Location tree of assets (parent/child adjacency) read through one connection.
+///
+/// The tree is not shared: it lives as long as the request which reads it and sees what its connection sees,
+/// uncommitted changes of the running transaction included. Nodes are fetched on demand by primary key and by parent,
+/// one IN list query per level of the tree, so ancestors and descendants are answered without the super parent view.
+/// The tree is not updated by writes, it must not be used after the request changed locations.
+///
+/// Queries throw on database errors.
+class Topology
+{
+public:
+    struct Node
+    {
+        uint32_t    id        = 0;
+        uint32_t    parentId  = 0;
+        uint16_t    typeId    = 0;
+        uint16_t    subtypeId = 0;
+        std::string name;
+        std::string status;
+    };
+
+    struct Filter
+    {
+        std::vector<uint16_t> types;
+        std::vector<uint16_t> subtypes;
+        std::string           status;
+    };
+
+public:
+    /// @param conn database established connection, used by the queries of the tree
+    explicit Topology(tnt::Connection& conn);
+
+    /// Returns node of given asset
+    /// @param id asset element id
+    std::optional<Node> node(uint32_t id);
+
+    /// Returns ancestors of given asset, nearest parent first
+    /// @param id asset element id
+    std::vector<Node> ancestors(uint32_t id);
+
+    /// Fetches given assets at once, for the callers which ask for many of them
+    /// @param ids asset element ids
+    void fetchNodes(const std::vector<uint32_t>& ids);
+
+    /// Fetches given assets and their ancestors at once, for the callers which ask for many of them
+    /// @param ids asset element ids
+    void fetchAncestors(const std::vector<uint32_t>& ids);
+
+    /// Returns assets located directly in given container
+    /// @param containerId container (datacenter, room, row, rack...) id
+    std::vector<Node> children(uint32_t containerId);
+
+    /// Fetches children of given containers at once, for the callers which ask for many of them
+    /// @param containerIds container ids
+    void fetchChildren(const std::vector<uint32_t>& containerIds);
+
+    /// Returns everything located (at any level) in given container, the container itself is not included
+    /// @param containerId container (datacenter, room, row, rack...) id
+    /// @param filter types, subtypes and status to select, empty means any
+    std::vector<Node> descendants(uint32_t containerId, const Filter& filter = {});
+
+    /// Returns ids of given container and of everything located (at any level) in it
+    /// @param containerId container (datacenter, room, row, rack...) id
+    std::unordered_set<uint32_t> subtree(uint32_t containerId);
+
+private:
+    tnt::Connection&                                    m_conn;
+    std::unordered_map<uint32_t, Node>                  m_nodes;
+    std::unordered_set<uint32_t>                        m_missing;  //!< ids fetched, but not found
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_children; //!< containers whose children were fetched
+};
+
+// =====================================================================================================================
+
+} // namespace fty::asset::db
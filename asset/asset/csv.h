@@ -44,9 +44,13 @@ Example:
 #pragma once
 
 #include <cstdint>
-#include <cxxtools/csvdeserializer.h>
+#include <cxxtools/serializationinfo.h>
+#include <cxxtools/string.h>
 #include <map>
+#include <optional>
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace fty::asset {
@@ -59,6 +63,9 @@ namespace fty::asset {
  * from csv file, so you can refer to columns using name of
  * field
  *
+ * All the cells are stored in one UTF-8 buffer, the table keeps
+ * only their offsets.
+ *
  */
 class CsvMap
 {
@@ -68,12 +75,19 @@ public:
     typedef std::vector<std::vector<cxxtools::String>> CxxData;
 
     /**
-     * \brief Creates new CsvMap instance with data inside
+     * \brief Column resolved by its title once, its cells are then accessed without the title lookup
      */
-    CsvMap(const Data& data)
-        : _data(data)
+    struct Column
     {
-    }
+        size_t index = 0;
+    };
+
+    class RowView;
+
+    /**
+     * \brief Creates new CsvMap instance with data inside
+     */
+    CsvMap(const Data& data);
 
     /**
      * \brief Creates an empty CsvMap instance
@@ -87,6 +101,16 @@ public:
      */
     CsvMap(const CxxData& data);
 
+    /**
+     * \brief Creates new CsvMap instance from UTF-8 encoded csv document
+     *
+     * The document is parsed in place, its buffer is kept by the instance.
+     *
+     * \throws std::invalid_argument if the document is not valid UTF-8
+     *         or a quoted cell is not terminated
+     */
+    static CsvMap parse(std::string&& text, char delimiter, char quote = '"');
+
     /**
      * \brief deserialize provided data, inicialize map of row title to index
      *
@@ -100,7 +124,54 @@ public:
      *
      * \throws std::out_of_range if row_i > data.size() or title_name is not known
      */
-    const std::string& get(size_t row_i, const std::string& title_name) const;
+    std::string get(size_t row_i, const std::string& title_name) const;
+
+    /**
+     * \brief return the content on row with the given title name, without copy
+     *
+     * The view is valid as long as the instance exists.
+     *
+     * \throws std::out_of_range if row_i > data.size() or title_name is not known
+     */
+    std::string_view view(size_t row_i, const std::string& title_name) const;
+
+    /**
+     * \brief return handle of the column with the given title name
+     *
+     * \throws std::out_of_range if title_name is not known
+     */
+    Column column(const std::string& title_name) const;
+
+    /**
+     * \brief return handle of the column with the given title name, nothing if the title is not known
+     */
+    std::optional<Column> findColumn(const std::string& title_name) const;
+
+    /**
+     * \brief return the content on row in the given column, without copy
+     *
+     * \throws std::out_of_range if row_i > data.size() or the row is shorter
+     */
+    std::string_view view(size_t row_i, Column col) const;
+
+    /**
+     * \brief return the content on row in the given column
+     *
+     * \throws std::out_of_range if row_i > data.size() or the row is shorter
+     */
+    std::string get(size_t row_i, Column col) const;
+
+    /**
+     * \brief return the content on row in the given column striped and in lower case
+     *
+     * \throws std::out_of_range if row_i > data.size() or the row is shorter
+     */
+    std::string get_strip(size_t row_i, Column col) const;
+
+    /**
+     * \brief return view of the row, its cells are accessed by column handles
+     */
+    RowView row(size_t row_i) const;
 
     /**
      * \brief return the content on row with the given title name striped and in lower case
@@ -114,7 +185,7 @@ public:
      */
     size_t rows() const
     {
-        return _data.size();
+        return _rows.empty() ? 0 : _rows.size() - 1;
     }
 
     /**
@@ -122,7 +193,7 @@ public:
      */
     size_t cols() const
     {
-        return _data[0].size();
+        return cellCount(0);
     }
 
     /**
@@ -131,9 +202,9 @@ public:
     bool hasTitle(const std::string& title_name) const;
 
     /**
-     * \brief get copy of titles
+     * \brief get titles
      */
-    std::set<std::string> getTitles() const;
+    const std::set<std::string>& getTitles() const;
 
     std::string getCreateUser() const;
     std::string getUpdateUser() const;
@@ -146,34 +217,101 @@ public:
     void setCreateMode(uint32_t mode);
 
 private:
-    Data                          _data;
+    struct Cell
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    void             addRow();
+    void             addCell(std::string_view value);
+    void             pushCell(size_t offset, size_t size);
+    size_t           cellCount(size_t row_i) const;
+    std::string_view cell(size_t row_i, size_t col_i) const;
+
+private:
+    std::string                   _buffer;
+    std::vector<Cell>             _cells;
+    std::vector<size_t>           _rows; // index of the first cell of every row, the last one ends the table
     std::map<std::string, size_t> _title_to_index;
+    std::set<std::string>         _titles;
     std::string                   _create_user, _update_user, _update_ts;
     uint32_t                      _create_mode;
 };
 
+/**
+ * \brief Lightweight view of one row of CsvMap, valid as long as the map exists
+ */
+class CsvMap::RowView
+{
+public:
+    RowView(const CsvMap& map, size_t row_i)
+        : _map(&map)
+        , _row(row_i)
+    {
+    }
+
+    size_t index() const
+    {
+        return _row;
+    }
+
+    std::string_view operator[](Column col) const
+    {
+        return _map->view(_row, col);
+    }
+
+private:
+    const CsvMap* _map;
+    size_t        _row;
+};
+
+inline CsvMap::RowView CsvMap::row(size_t row_i) const
+{
+    return RowView(*this, row_i);
+}
+
 // TODO: does not belongs to csv, move somewhere else
 void skip_utf8_BOM(std::istream& i);
 
 /**
- * \brief find the delimiter used in csv file
- *
- * \param i istream, which is analyzed
- * \param max_pos specifies how many bytes should be investigated before
- *                0 is returned. Defaults to 60.
- *
- * \return delimeter or '0 if nothing found in first max_pos bytes
+ * \brief Dialect of csv document, as detected by sniffDialect
  */
-char findDelimiter(std::istream& i, std::size_t max_pos = 60);
+struct CsvDialect
+{
+    enum class Encoding
+    {
+        Utf8,
+        Utf16LE,
+        Utf16BE
+    };
+
+    enum class LineEnding
+    {
+        Lf,
+        CrLf,
+        Cr
+    };
+
+    char       delimiter  = '\x0';          //!< comma, semicolon or tabulator, '\x0' if not detected
+    double     confidence = 0;              //!< share of sampled records with the same count of delimiters as titles
+    char       quote      = '"';            //!< quote character, double quote or apostrophe
+    bool       bom        = false;          //!< document starts with byte order mark
+    Encoding   encoding   = Encoding::Utf8; //!< UTF-16 is exported by Excel as "Unicode text"
+    LineEnding lineEnding = LineEnding::Lf; //!< most frequent line ending
+};
 
 /**
- * \brief check apostrofs
+ * \brief detect the dialect of csv document
+ *
+ * The document is read once, from the beginning, quoted values are skipped.
  *
- * \param i istream, which is analyzed
+ * \param text raw document, which is analyzed
+ * \param max_records specifies how many records are investigated. Defaults to 64.
  *
- * \return true if there is at leas one apostrof
+ * \return detected dialect
  */
-bool hasApostrof(std::istream& i);
+CsvDialect sniffDialect(std::string_view text, std::size_t max_records = 64);
 
 /**
  *  \brief read the data from istream
@@ -185,6 +323,60 @@ bool hasApostrof(std::istream& i);
  */
 CsvMap CsvMap_from_istream(std::istream& in);
 
+/**
+ *  \brief read the data from UTF-8 encoded document
+ *
+ *  \param text csv document (UTF-8 or UTF-16), moved to CsvMap instance
+ *  \return CsvMap instance
+ *  \throws invalid_argument if delimiter was not autodetected
+ *          or the document is not valid
+ */
+CsvMap CsvMap_from_string(std::string text);
+
+/**
+ * \class CsvReader
+ *
+ * \brief Reads csv document from a stream in parts
+ *
+ * The stream is read in blocks and split on record boundaries, every part is a CsvMap with the titles and at most
+ * given count of rows, so the memory used does not depend on the size of the document.
+ */
+class CsvReader
+{
+public:
+    /// \brief reader of the stream, which is read in blocks of given size
+    explicit CsvReader(std::istream& in, std::size_t block_size = 64 * 1024);
+
+    /// \brief dialect of the document, detected from its first 64 KiB
+    const CsvDialect& dialect() const;
+
+    /**
+     *  \brief read next part of the document
+     *
+     *  \param rows maximal count of rows of the part, titles excluded
+     *  \return CsvMap with the titles and the rows of the part, nothing at the end of the document
+     *  \throws invalid_argument if delimiter was not autodetected
+     *          or the document is not valid
+     */
+    std::optional<CsvMap> next(std::size_t rows);
+
+private:
+    void        start();
+    std::string read(std::size_t size);
+    void        append(std::string_view block);
+    bool        fill();
+    std::size_t records(std::size_t count, std::size_t& found) const;
+
+    std::istream& _in;
+    std::size_t   _block_size;
+    CsvDialect    _dialect;
+    bool          _started = false;
+    bool          _eof     = false;
+    std::string   _raw;     //!< UTF-16 bytes not decoded yet
+    std::string   _pending; //!< UTF-8 text not split to parts yet
+    std::string   _titles;  //!< title record, starts every part
+};
+
 /**
  *  \brief read the data from serialization info
  *
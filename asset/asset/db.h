@@ -1,10 +1,21 @@
 #pragma once
 
+#include "env.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <fmt/format.h>
 #include <fty/split.h>
 #include <fty/traits.h>
 #include <fty_common_db_dbpath.h>
+#include <fty_log.h>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <tntdb.h>
+#include <tuple>
+#include <unordered_map>
 
 namespace tnt {
 
@@ -34,13 +45,91 @@ class Statement;
 class ConstIterator;
 class Rows;
 class Row;
+class Cursor;
+class CursorIterator;
 
+// =====================================================================================================================
+
+/// Process-wide pool of database connections.
+///
+/// A thread gets back the connection it used last when that one is idle, so its prepared statements stay hot.
+/// Pool size is limited (FTY_ASSET_DB_POOL_SIZE), when all the connections are in use, callers wait for a free one
+/// (at most FTY_ASSET_DB_POOL_TIMEOUT seconds). A thread which already holds a connection never waits, it gets a
+/// connection above the limit instead, which is closed when released. Connections which stayed idle for a while
+/// are pinged before they are handed out. Statistics of the pool are logged every FTY_ASSET_DB_POOL_REPORT seconds
+/// (0 disables the report).
+class ConnectionPool
+{
+public:
+    struct Stats
+    {
+        size_t                    size       = 0; //!< opened connections
+        size_t                    inUse      = 0; //!< connections in use
+        uint64_t                  acquired   = 0; //!< number of acquisitions
+        uint64_t                  waits      = 0; //!< acquisitions which had to wait for a free connection
+        uint64_t                  overflows  = 0; //!< connections opened above the limit
+        uint64_t                  reconnects = 0; //!< connections replaced after failed health check
+        std::chrono::microseconds waitTime{0};    //!< total time spent waiting
+        std::chrono::microseconds maxWaitTime{0}; //!< longest wait
+    };
+
+public:
+    static ConnectionPool& instance();
+
+    tntdb::Connection acquire();
+    /// @param owner thread which acquired the connection, it can be released by another one
+    void              release(tntdb::Connection&& conn, std::thread::id owner);
+    Stats             stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot
+    {
+        tntdb::Connection conn;
+        std::thread::id   owner;
+        Clock::time_point lastUsed;
+    };
+
+    ConnectionPool();
+
+    static tntdb::Connection open();
+
+    void acquired(std::thread::id owner);
+    void released(std::thread::id owner);
+    void report(const Stats& stats) const;
+
+private:
+    mutable std::mutex                          m_mutex;
+    std::condition_variable                     m_cond;
+    std::vector<Slot>                           m_idle;
+    std::unordered_map<std::thread::id, size_t> m_held; //!< connections in use by the threads which acquired them
+    size_t                                      m_maxSize;
+    std::chrono::seconds                        m_timeout;
+    std::chrono::seconds                        m_checkAfter = std::chrono::seconds(30);
+    std::chrono::seconds                        m_reportAfter;
+    Clock::time_point                           m_reported = Clock::now();
+    Stats                                       m_stats;
+};
+
+// =====================================================================================================================
+
+/// Database connection drawn from the pool for the lifetime of the object.
+/// The connection is accounted to the thread which created the object, also when it is destroyed by another thread
+/// (a job or a stream handed over to a worker), so the pool's per-thread decisions stay correct.
 class Connection
 {
 public:
     Connection();
+    ~Connection();
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
     Statement prepare(const std::string& sql);
 
+    /// Underlying tntdb connection, for the code which works with tntdb directly
+    tntdb::Connection& connection();
+
 public:
     template <typename... Args>
     Row selectRow(const std::string& queryStr, Args&&... args);
@@ -48,6 +137,9 @@ public:
     template <typename... Args>
     Rows select(const std::string& queryStr, Args&&... args);
 
+    template <typename... Args>
+    Cursor cursor(const std::string& queryStr, Args&&... args);
+
     template <typename... Args>
     uint execute(const std::string& queryStr, Args&&... args);
 
@@ -55,6 +147,7 @@ public:
 
 private:
     tntdb::Connection m_connection;
+    std::thread::id   m_owner;
     friend class Transaction;
 };
 
@@ -73,12 +166,25 @@ public:
     template <typename T>
     void get(const std::string& name, T& val) const;
 
+    /// Gets value by column index, strings are assigned into given value (no temporary)
+    template <typename T>
+    void get(size_t col, T& val) const;
+
+    bool isNull(const std::string& col) const;
+
+    size_t      size() const;
+    std::string name(size_t col) const;
+
 private:
     Row(const tntdb::Row& row);
 
+    template <typename T, typename Col>
+    T getAs(const Col& col) const;
+
     friend class Statement;
     friend class ConstIterator;
     friend class Rows;
+    friend class CursorIterator;
     tntdb::Row m_row;
 };
 
@@ -137,6 +243,51 @@ public:
 
 // =====================================================================================================================
 
+class CursorIterator
+{
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Row;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const Row*;
+    using reference         = const Row&;
+
+    bool            operator==(const CursorIterator& it) const;
+    bool            operator!=(const CursorIterator& it) const;
+    CursorIterator& operator++();
+    const Row&      operator*() const;
+    const Row*      operator->() const;
+
+private:
+    CursorIterator(const tntdb::Statement::const_iterator& it, const tntdb::Statement::const_iterator& end);
+    void update();
+
+    tntdb::Statement::const_iterator m_it;
+    tntdb::Statement::const_iterator m_end;
+    Row                              m_current;
+    friend class Cursor;
+};
+
+// =====================================================================================================================
+
+/// Forward only cursor over the result of a statement. Rows are fetched from the server by chunks while iterating,
+/// so the whole result is never held in memory. Iterate only once.
+class Cursor
+{
+public:
+    CursorIterator begin() const;
+    CursorIterator end() const;
+
+private:
+    Cursor(const tntdb::Statement& st, unsigned fetchSize);
+
+    tntdb::Statement m_st;
+    unsigned         m_fetchSize;
+    friend class Statement;
+};
+
+// =====================================================================================================================
+
 class Statement
 {
 public:
@@ -155,11 +306,20 @@ public:
     template <typename TArg>
     Statement& bindMulti(size_t count, Arg<TArg>&& arg);
 
+    /// Binds values of IN list generated by @ref inList, list is padded by the last value
+    template <typename T>
+    Statement& bindList(const std::string& name, const std::vector<T>& values);
+
     Statement& bind();
 
 public:
     Row  selectRow() const;
     Rows select() const;
+
+    /// Executes the select and returns a streaming cursor over its result
+    /// @param fetchSize count of rows fetched from the server at once
+    Cursor cursor(unsigned fetchSize = 256) const;
+
     uint execute() const;
 
 private:
@@ -174,12 +334,32 @@ private:
 class Transaction
 {
 public:
-    Transaction(Connection& con);
+    enum class Isolation
+    {
+        Default,      //!< isolation level of the session (REPEATABLE READ)
+        ReadCommitted //!< no gap locks: writers of different rows don't wait for each other's index ranges
+    };
+
+public:
+    Transaction(Connection& con, Isolation isolation = Isolation::Default);
 
     void commit();
     void rollback();
 
+    /// Sets named savepoint, changes made after it can be rolled back without aborting the transaction
+    void savepoint(const std::string& name);
+
+    /// Rolls back changes made after the savepoint, the savepoint is kept
+    void rollbackTo(const std::string& name);
+
+    /// Removes the savepoint, changes made after it are kept
+    void release(const std::string& name);
+
 private:
+    static tntdb::Connection& isolated(tntdb::Connection& con, Isolation isolation);
+
+private:
+    tntdb::Connection& m_connection;
     tntdb::Transaction m_trans;
 };
 
@@ -200,6 +380,150 @@ inline std::string multiInsert(std::initializer_list<std::string> cols, size_t c
     return out;
 }
 
+/// Count of values in IN list of given size: lists are padded to the next power of two, so a few statement shapes
+/// (and prepared statements) exist for any list size
+inline size_t inListSize(size_t count)
+{
+    size_t size = 1;
+    while (size < count) {
+        size <<= 1;
+    }
+    return size;
+}
+
+/// Generates placeholders of IN list, values have to be bound by @ref Statement::bindList
+inline std::string inList(const std::string& col, size_t count)
+{
+    std::string out;
+    for (size_t i = 0; i < inListSize(count); ++i) {
+        out += fmt::format("{}:{}_{}", i > 0 ? ", " : "", col, i);
+    }
+    return out;
+}
+
+/// Splits rows of multi-row statement to batches of power of two sizes (maxBatch has to be power of two as well), so
+/// a few statement shapes (and prepared statements) exist for any count of rows
+inline std::vector<size_t> batchSizes(size_t count, size_t maxBatch = 64)
+{
+    std::vector<size_t> out;
+    for (; count >= maxBatch; count -= maxBatch) {
+        out.push_back(maxBatch);
+    }
+    for (size_t size = maxBatch >> 1; size > 0; size >>= 1) {
+        if (count & size) {
+            out.push_back(size);
+        }
+    }
+    return out;
+}
+
+// =====================================================================================================================
+
+/// Column of @ref RowMapper: sql expression, its alias in the result and member the value is stored to
+template <typename C, typename M>
+struct Column
+{
+    const char* expr;
+    const char* alias;
+    M C::*      member;
+};
+
+template <typename C, typename M>
+constexpr Column<C, M> column(const char* expr, const char* alias, M C::*member)
+{
+    return {expr, alias, member};
+}
+
+/// Maps columns of a result to members of T. Mapping is declared once, the select list is generated from it, and
+/// column indexes are resolved once per result, so rows are fetched by position.
+///
+///     static const auto mapper = tnt::rowMapper<Link>(
+///         tnt::column("l.id_link", "id", &Link::id),
+///         tnt::column("l.src_out", "srcOut", &Link::srcOut)
+///     );
+///     auto sql = "SELECT " + mapper.selectList() + " FROM t_bios_asset_link l";
+///     auto idx = mapper.resolve(rows);
+///     for (const auto& row : rows) {
+///         mapper.fetch(row, idx, link);
+///     }
+template <typename T, typename... Cols>
+class RowMapper
+{
+public:
+    using Indexes = std::array<size_t, sizeof...(Cols)>;
+
+    constexpr explicit RowMapper(Cols... cols)
+        : m_cols(cols...)
+    {
+    }
+
+    /// Comma separated list of 'expr as alias'
+    std::string selectList() const
+    {
+        std::string out;
+        std::apply(
+            [&](const auto&... col) {
+                ((out += fmt::format("{}{} as {}", out.empty() ? "" : ", ", col.expr, col.alias)), ...);
+            },
+            m_cols);
+        return out;
+    }
+
+    /// Resolves indexes of the columns by aliases
+    Indexes resolve(const Row& row) const
+    {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < row.size(); ++i) {
+            names.push_back(row.name(i));
+        }
+
+        Indexes idx;
+        size_t  pos = 0;
+        std::apply(
+            [&](const auto&... col) {
+                ((idx[pos++] = indexOf(names, col.alias)), ...);
+            },
+            m_cols);
+        return idx;
+    }
+
+    /// Resolves indexes of the columns by aliases, result must not be empty
+    Indexes resolve(const Rows& rows) const
+    {
+        return resolve(rows[0]);
+    }
+
+    /// Fills object from the row
+    void fetch(const Row& row, const Indexes& idx, T& obj) const
+    {
+        size_t pos = 0;
+        std::apply(
+            [&](const auto&... col) {
+                (row.get(idx[pos++], obj.*(col.member)), ...);
+            },
+            m_cols);
+    }
+
+private:
+    static size_t indexOf(const std::vector<std::string>& names, const char* alias)
+    {
+        auto it = std::find(names.begin(), names.end(), alias);
+        if (it == names.end()) {
+            throw std::out_of_range(fmt::format("column '{}' is not in the result", alias));
+        }
+        return size_t(it - names.begin());
+    }
+
+private:
+    std::tuple<Cols...> m_cols;
+};
+
+template <typename T, typename... Cols>
+constexpr RowMapper<T, Cols...> rowMapper(Cols... cols)
+{
+    return RowMapper<T, Cols...>(cols...);
+}
+
 } // namespace tnt
 
 // =====================================================================================================================
@@ -244,15 +568,181 @@ std::optional<std::decay_t<T>> nullable(bool cond, T&& value)
     return std::nullopt;
 }
 
+// =====================================================================================================================
+// Connection pool impl
+// =====================================================================================================================
+
+inline tnt::ConnectionPool::ConnectionPool()
+    : m_maxSize(std::max<size_t>(1, fty::asset::envNumber("FTY_ASSET_DB_POOL_SIZE", 16)))
+    , m_timeout(fty::asset::envSeconds("FTY_ASSET_DB_POOL_TIMEOUT", 30))
+    , m_reportAfter(fty::asset::envSeconds("FTY_ASSET_DB_POOL_REPORT", 300))
+{
+}
+
+inline tnt::ConnectionPool& tnt::ConnectionPool::instance()
+{
+    static ConnectionPool pool;
+    return pool;
+}
+
+inline tntdb::Connection tnt::ConnectionPool::open()
+{
+    return tntdb::connect(getenv("DBURL") ? getenv("DBURL") : DBConn::url);
+}
+
+// Must be called with the mutex locked
+inline void tnt::ConnectionPool::acquired(std::thread::id owner)
+{
+    ++m_stats.inUse;
+    ++m_held[owner];
+}
+
+// Must be called with the mutex locked
+inline void tnt::ConnectionPool::released(std::thread::id owner)
+{
+    --m_stats.inUse;
+    if (auto it = m_held.find(owner); it != m_held.end() && --it->second == 0) {
+        m_held.erase(it);
+    }
+    m_cond.notify_one();
+}
+
+inline void tnt::ConnectionPool::report(const Stats& stats) const
+{
+    log_info("Database connection pool: %zu opened, %zu in use, %llu acquired, %llu waits (%lld ms in total, %lld ms "
+             "max), %llu overflows, %llu reconnects",
+        stats.size, stats.inUse, static_cast<unsigned long long>(stats.acquired),
+        static_cast<unsigned long long>(stats.waits), static_cast<long long>(stats.waitTime.count() / 1000),
+        static_cast<long long>(stats.maxWaitTime.count() / 1000), static_cast<unsigned long long>(stats.overflows),
+        static_cast<unsigned long long>(stats.reconnects));
+}
+
+inline tntdb::Connection tnt::ConnectionPool::acquire()
+{
+    auto self  = std::this_thread::get_id();
+    auto start = Clock::now();
+
+    std::unique_lock lock(m_mutex);
+    ++m_stats.acquired;
+
+    bool waited = false;
+    while (m_idle.empty() && m_stats.size >= m_maxSize && !m_held.count(self)) {
+        if (!waited) {
+            ++m_stats.waits;
+            waited = true;
+        }
+        if (m_cond.wait_until(lock, start + m_timeout) == std::cv_status::timeout && m_idle.empty() &&
+            m_stats.size >= m_maxSize) {
+            throw std::runtime_error(fmt::format("no free database connection after {}s", m_timeout.count()));
+        }
+    }
+
+    if (waited) {
+        auto waitTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        m_stats.waitTime += waitTime;
+        m_stats.maxWaitTime = std::max(m_stats.maxWaitTime, waitTime);
+        if (waitTime > std::chrono::seconds(1)) {
+            log_warning("Waited %lld ms for database connection (%zu/%zu in use)",
+                static_cast<long long>(waitTime.count() / 1000), m_stats.inUse, m_maxSize);
+        }
+    }
+
+    acquired(self);
+
+    if (m_idle.empty()) {
+        if (m_stats.size >= m_maxSize) {
+            ++m_stats.overflows;
+        }
+        ++m_stats.size;
+        lock.unlock();
+
+        try {
+            return open();
+        } catch (...) {
+            lock.lock();
+            --m_stats.size;
+            released(self);
+            throw;
+        }
+    }
+
+    // Prefer the connection this thread used last, otherwise the most recently used one
+    auto it = std::find_if(m_idle.begin(), m_idle.end(), [&](const Slot& slot) {
+        return slot.owner == self;
+    });
+    if (it == m_idle.end()) {
+        it = std::prev(m_idle.end());
+    }
+    Slot slot = std::move(*it);
+    m_idle.erase(it);
+    lock.unlock();
+
+    try {
+        if (Clock::now() - slot.lastUsed > m_checkAfter && !slot.conn.ping()) {
+            slot.conn = open();
+            std::lock_guard guard(m_mutex);
+            ++m_stats.reconnects;
+        }
+    } catch (...) {
+        lock.lock();
+        --m_stats.size;
+        released(self);
+        throw;
+    }
+
+    return slot.conn;
+}
+
+inline void tnt::ConnectionPool::release(tntdb::Connection&& conn, std::thread::id owner)
+{
+    std::optional<Stats> stats;
+    {
+        std::lock_guard lock(m_mutex);
+        released(owner);
+        if (m_stats.size > m_maxSize) {
+            // connection above the limit
+            --m_stats.size;
+        } else {
+            m_idle.push_back({std::move(conn), owner, Clock::now()});
+        }
+
+        if (m_reportAfter.count() && Clock::now() - m_reported >= m_reportAfter) {
+            m_reported = Clock::now();
+            stats      = m_stats;
+        }
+    }
+
+    if (stats) {
+        report(*stats);
+    }
+}
+
+inline tnt::ConnectionPool::Stats tnt::ConnectionPool::stats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
 // =====================================================================================================================
 // Connection impl
 // =====================================================================================================================
 
 inline tnt::Connection::Connection()
-    : m_connection(tntdb::connectCached(getenv("DBURL") ? getenv("DBURL") : DBConn::url))
+    : m_connection(ConnectionPool::instance().acquire())
+    , m_owner(std::this_thread::get_id())
 {
 }
 
+inline tnt::Connection::~Connection()
+{
+    ConnectionPool::instance().release(std::move(m_connection), m_owner);
+}
+
+inline tntdb::Connection& tnt::Connection::connection()
+{
+    return m_connection;
+}
+
 inline tnt::Statement tnt::Connection::prepare(const std::string& sql)
 {
     return Statement(m_connection.prepareCached(sql));
@@ -270,6 +760,12 @@ inline tnt::Rows tnt::Connection::select(const std::string& queryStr, Args&&...
     return Statement(m_connection.prepareCached(queryStr)).bind(std::forward<Args>(args)...).select();
 }
 
+template <typename... Args>
+inline tnt::Cursor tnt::Connection::cursor(const std::string& queryStr, Args&&... args)
+{
+    return Statement(m_connection.prepareCached(queryStr)).bind(std::forward<Args>(args)...).cursor();
+}
+
 template <typename... Args>
 inline uint tnt::Connection::execute(const std::string& queryStr, Args&&... args)
 {
@@ -337,6 +833,19 @@ inline tnt::Statement& tnt::Statement::bindMulti(size_t count, Arg<TArg>&& arg)
 }
 
 
+template <typename T>
+inline tnt::Statement& tnt::Statement::bindList(const std::string& name, const std::vector<T>& values)
+{
+    if (values.empty()) {
+        throw std::invalid_argument(fmt::format("empty list '{}'", name));
+    }
+
+    for (size_t i = 0; i < inListSize(values.size()); ++i) {
+        m_st.set(fmt::format("{}_{}", name, i), values[std::min(i, values.size() - 1)]);
+    }
+    return *this;
+}
+
 inline tnt::Row tnt::Statement::selectRow() const
 {
     return Row(m_st.selectRow());
@@ -347,6 +856,11 @@ inline tnt::Rows tnt::Statement::select() const
     return Rows(m_st.select());
 }
 
+inline tnt::Cursor tnt::Statement::cursor(unsigned fetchSize) const
+{
+    return Cursor(m_st, fetchSize);
+}
+
 inline uint tnt::Statement::execute() const
 {
     return m_st.execute();
@@ -363,6 +877,12 @@ inline tnt::Statement::Statement(const tntdb::Statement& st)
 
 template <typename T>
 inline T tnt::Row::get(const std::string& col) const
+{
+    return getAs<T>(col);
+}
+
+template <typename T, typename Col>
+inline T tnt::Row::getAs(const Col& col) const
 {
     if (m_row.isNull(col)) {
         return {};
@@ -416,6 +936,36 @@ inline void tnt::Row::get(const std::string& name, T& val) const
     val = get<std::decay_t<T>>(name);
 }
 
+template <typename T>
+inline void tnt::Row::get(size_t col, T& val) const
+{
+    auto index = tntdb::Row::size_type(col);
+    if constexpr (std::is_same_v<T, std::string>) {
+        if (m_row.isNull(index)) {
+            val.clear();
+        } else {
+            m_row.getValue(index).getString(val);
+        }
+    } else {
+        val = getAs<T>(index);
+    }
+}
+
+inline size_t tnt::Row::size() const
+{
+    return m_row.size();
+}
+
+inline std::string tnt::Row::name(size_t col) const
+{
+    return m_row.getName(tntdb::Row::size_type(col));
+}
+
+inline bool tnt::Row::isNull(const std::string& col) const
+{
+    return m_row.isNull(col);
+}
+
 inline tnt::Row::Row(const tntdb::Row& row)
     : m_row(row)
 {
@@ -558,13 +1108,85 @@ inline tnt::Rows::Rows()
 }
 
 
+// =====================================================================================================================
+// Cursor impl
+// =====================================================================================================================
+
+inline tnt::CursorIterator::CursorIterator(
+    const tntdb::Statement::const_iterator& it, const tntdb::Statement::const_iterator& end)
+    : m_it(it)
+    , m_end(end)
+{
+    update();
+}
+
+inline void tnt::CursorIterator::update()
+{
+    if (m_it != m_end) {
+        m_current = Row(*m_it);
+    }
+}
+
+inline bool tnt::CursorIterator::operator==(const CursorIterator& it) const
+{
+    return m_it == it.m_it;
+}
+
+inline bool tnt::CursorIterator::operator!=(const CursorIterator& it) const
+{
+    return !operator==(it);
+}
+
+inline tnt::CursorIterator& tnt::CursorIterator::operator++()
+{
+    ++m_it;
+    update();
+    return *this;
+}
+
+inline const tnt::Row& tnt::CursorIterator::operator*() const
+{
+    return m_current;
+}
+
+inline const tnt::Row* tnt::CursorIterator::operator->() const
+{
+    return &m_current;
+}
+
+inline tnt::Cursor::Cursor(const tntdb::Statement& st, unsigned fetchSize)
+    : m_st(st)
+    , m_fetchSize(fetchSize)
+{
+}
+
+inline tnt::CursorIterator tnt::Cursor::begin() const
+{
+    return CursorIterator(m_st.begin(m_fetchSize), m_st.end());
+}
+
+inline tnt::CursorIterator tnt::Cursor::end() const
+{
+    return CursorIterator(m_st.end(), m_st.end());
+}
+
 // =====================================================================================================================
 // Transaction impl
 // =====================================================================================================================
 
-inline tnt::Transaction::Transaction(Connection& con)
-    : m_trans(tntdb::Transaction(con.m_connection))
+inline tnt::Transaction::Transaction(Connection& con, Isolation isolation)
+    : m_connection(con.m_connection)
+    , m_trans(tntdb::Transaction(isolated(con.m_connection, isolation)))
+{
+}
+
+// Isolation level applies to the next transaction of the connection only
+inline tntdb::Connection& tnt::Transaction::isolated(tntdb::Connection& con, Isolation isolation)
 {
+    if (isolation == Isolation::ReadCommitted) {
+        con.execute("SET TRANSACTION ISOLATION LEVEL READ COMMITTED");
+    }
+    return con;
 }
 
 inline void tnt::Transaction::commit()
@@ -576,3 +1198,18 @@ inline void tnt::Transaction::rollback()
 {
     m_trans.rollback();
 }
+
+inline void tnt::Transaction::savepoint(const std::string& name)
+{
+    m_connection.execute("SAVEPOINT " + name);
+}
+
+inline void tnt::Transaction::rollbackTo(const std::string& name)
+{
+    m_connection.execute("ROLLBACK TO SAVEPOINT " + name);
+}
+
+inline void tnt::Transaction::release(const std::string& name)
+{
+    m_connection.execute("RELEASE SAVEPOINT " + name);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <chrono>
+#include <cstdlib>
+#include <fty_log.h>
+#include <string>
+
+namespace fty::asset {
+
+/// Returns numeric setting from the environment, default value if the variable is not set or is not a number
+inline size_t envNumber(const char* name, size_t defaultValue)
+{
+    if (const char* value = getenv(name)) {
+        try {
+            return size_t(std::stoul(value));
+        } catch (const std::exception&) {
+            log_warning("Wrong value of %s: '%s', %zu is used", name, value, defaultValue);
+        }
+    }
+    return defaultValue;
+}
+
+/// Returns time setting (in seconds) from the environment, default value if the variable is not set or is not a number
+inline std::chrono::seconds envSeconds(const char* name, size_t defaultValue)
+{
+    return std::chrono::seconds(envNumber(name, defaultValue));
+}
+
+} // namespace fty::asset
@@ -19,6 +19,7 @@
  */
 
 #include "asset/asset-computed.h"
+#include "asset/db.h"
 #include <fty/convert.h>
 #include <fty_common.h>
 #include <fty_common_db_asset.h>
@@ -50,8 +51,8 @@ static int s_get_devices_usize(tntdb::Connection& conn, std::set<uint32_t>& elem
 int free_u_size(uint32_t elementId)
 {
     try {
-        tntdb::Connection conn;
-        conn = tntdb::connect(DBConn::url);
+        tnt::Connection db;
+        auto&           conn = db.connection();
 
         // get the rack u_size
         std::set<uint32_t> rack_id{elementId};
@@ -115,12 +116,15 @@ static uint32_t s_select_outlet_count(tntdb::Connection& conn, uint32_t id)
 
 int rack_outlets_available(uint32_t elementId, std::map<std::string, int>& res)
 {
-    int               sum     = -1;
-    bool              tainted = false;
-    tntdb::Connection conn;
-    res["sum"] = sum;
+    int  sum     = -1;
+    bool tainted = false;
+    res["sum"]   = sum;
+
+    std::optional<tnt::Connection> db;
+
+    std::function<void(const tntdb::Row& row)> cb = [&db, &sum, &tainted, &res](const tntdb::Row& row) {
+        auto& conn = db->connection();
 
-    std::function<void(const tntdb::Row& row)> cb = [&conn, &sum, &tainted, &res](const tntdb::Row& row) {
         uint32_t device_subtype = 0;
         row["subtype_id"].get(device_subtype);
         if (!persist::is_epdu(int(device_subtype)) && !persist::is_pdu(int(device_subtype)))
@@ -147,8 +151,8 @@ int rack_outlets_available(uint32_t elementId, std::map<std::string, int>& res)
 
     int rv;
     try {
-        conn = tntdb::connect(DBConn::url);
-        rv   = DBAssets::select_assets_by_container(conn, elementId, cb);
+        db.emplace();
+        rv = DBAssets::select_assets_by_container(db->connection(), elementId, cb);
     } catch (std::exception& e) {
         log_error("%s", e.what());
         return -1;
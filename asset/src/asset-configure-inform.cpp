@@ -19,6 +19,8 @@
  */
 
 #include "asset/asset-configure-inform.h"
+#include "asset/asset-publisher.h"
+#include "asset/asset-topology.h"
 #include "asset/db.h"
 #include <fty_common.h>
 #include <fty_common_db.h>
@@ -39,65 +41,50 @@ static zhash_t* s_map2zhash(const std::map<std::string, std::string>& m)
     return ret;
 }
 
-static bool getDcUPSes(tnt::Connection& conn, const std::string& assetName, zhash_t* hash)
-{
-    std::vector<std::string> listUps;
-
-    auto cb = [&listUps](const tnt::Row& row) {
-        listUps.push_back(row.get("name"));
-    };
-
-    auto dcId = db::nameToAssetId(assetName);
-    if (!dcId) {
-        return false;
-    }
-
-    auto rv = db::selectAssetsByContainer(
-        conn, uint32_t(*dcId), {persist::asset_type::DEVICE}, {persist::asset_subtype::UPS}, "", "active", cb);
-
-    if (!rv) {
-        return false;
-    }
-
-    int i = 0;
-    for (auto& ups : listUps) {
-        char key[14];
-        sprintf(key, "ups%d", i);
-        char* ups_name = strdup(ups.c_str());
-        zhash_insert(hash, key, reinterpret_cast<void*>(ups_name));
-        i++;
-    }
-    return true;
-}
-
-
 static void* voidify(const std::string& str)
 {
     return reinterpret_cast<void*>(const_cast<char*>(str.c_str()));
 }
 
-Expected<void> sendConfigure(
-    const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows, const std::string& agentName)
+Expected<void> sendConfigure(const std::vector<std::pair<db::AssetElement, persist::asset_operation>>& rows)
 {
-    mlm_client_t* client = mlm_client_new();
+    // super parent view exposes 10 levels of parents
+    static constexpr size_t MAX_PARENTS = 10;
 
-    if (!client) {
-        return unexpected("mlm_client_new () failed.");
-    }
-
-    int r = mlm_client_connect(client, MLM_ENDPOINT, 1000, agentName.c_str());
-    if (r == -1) {
-        mlm_client_destroy(&client);
-        return unexpected("mlm_client_connect () failed.");
-    }
+    auto&           publisher = Publisher::instance();
+    tnt::Connection conn;
+    db::Topology    topology(conn);
+
+    // Parent chains and datacenters are resolved from the topology, UPS lists once per datacenter
+    std::map<uint32_t, std::vector<db::Topology::Node>> parentChains;
+    std::map<uint32_t, std::string>                     upsDatacenters;
+
+    auto parentChain = [&](uint32_t parentId) -> const std::vector<db::Topology::Node>& {
+        auto it = parentChains.find(parentId);
+        if (it == parentChains.end()) {
+            std::vector<db::Topology::Node> chain;
+            if (auto parent = topology.node(parentId)) {
+                chain.push_back(*parent);
+                for (auto& node : topology.ancestors(parentId)) {
+                    chain.push_back(std::move(node));
+                }
+            }
+            if (chain.size() > MAX_PARENTS) {
+                chain.resize(MAX_PARENTS);
+            }
+            it = parentChains.emplace(parentId, std::move(chain)).first;
+        }
+        return it->second;
+    };
 
-    r = mlm_client_set_producer(client, FTY_PROTO_STREAM_ASSETS);
-    if (r == -1) {
-        mlm_client_destroy(&client);
-        return unexpected(" mlm_client_set_producer () failed.");
+    std::vector<uint32_t> parentIds;
+    for (const auto& oneRow : rows) {
+        if (oneRow.first.parentId) {
+            parentIds.push_back(oneRow.first.parentId);
+        }
     }
+    topology.fetchAncestors(parentIds);
 
-    tnt::Connection conn;
     for (const auto& oneRow : rows) {
 
         std::string s_priority    = std::to_string(oneRow.first.priority);
@@ -122,79 +109,66 @@ Expected<void> sendConfigure(
         zhash_insert(aux, "status", voidify(oneRow.first.status));
 
         // this is a bit hack, but we now that our topology ends with datacenter (hopefully)
-        std::string dc_name;
-
-        auto cb = [aux, &dc_name](const tnt::Row& row) {
-            for (const auto& name : {"parent_name1", "parent_name2", "parent_name3", "parent_name4", "parent_name5",
-                     "parent_name6", "parent_name7", "parent_name8", "parent_name9", "parent_name10"}) {
-                std::string foo       = row.get(name);
-                std::string hash_name = name;
-                // 11 == strlen ("parent_name")
-                hash_name.insert(11, 1, '.');
-                if (!foo.empty()) {
-                    zhash_insert(aux, hash_name.c_str(), voidify(foo));
-                    dc_name = foo;
-                }
-            }
-        };
-        auto res = db::selectAssetElementSuperParent(oneRow.first.id, cb);
-        if (!res) {
-            logError("selectAssetElementSuperParent error: {}", res.error());
-            zhash_destroy(&aux);
-            mlm_client_destroy(&client);
-            return unexpected("persist::select_asset_element_super_parent () failed.");
+        const auto& parents = parentChain(oneRow.first.parentId);
+        for (size_t i = 0; i < parents.size(); ++i) {
+            zhash_insert(aux, fmt::format("parent_name.{}", i + 1).c_str(), voidify(parents[i].name));
         }
 
         zhash_t* ext = s_map2zhash(oneRow.first.ext);
 
         zmsg_t* msg = fty_proto_encode_asset(aux, oneRow.first.name.c_str(), operation2str(oneRow.second).c_str(), ext);
 
-        r = mlm_client_send(client, subject.c_str(), &msg);
-        if (r != 0) {
-            mlm_client_destroy(&client);
-            return unexpected("mlm_client_send () failed.");
-        }
-
         zhash_destroy(&aux);
         zhash_destroy(&ext);
 
+        if (!publisher.publish(subject, &msg)) {
+            return unexpected("Asset publisher is stopped");
+        }
+
         // ask fty-asset to republish so we would get UUID
         if (streq(operation2str(oneRow.second).c_str(), FTY_PROTO_ASSET_OP_CREATE) ||
             streq(operation2str(oneRow.second).c_str(), FTY_PROTO_ASSET_OP_UPDATE)) {
             zmsg_t* republish = zmsg_new();
             zmsg_addstr(republish, s_asset_name.c_str());
-            mlm_client_sendto(client, "asset-agent", "REPUBLISH", nullptr, 5000, &republish);
+            publisher.sendTo("asset-agent", "REPUBLISH", &republish);
         }
 
         // data for uptime
-        if (oneRow.first.subtypeId == persist::asset_subtype::UPS) {
-            zhash_t* aux1 = zhash_new();
-
-            if (!getDcUPSes(conn, dc_name, aux1))
-                log_error("Cannot read upses for dc with id = %s", dc_name.c_str());
-
-            zhash_update(aux1, "type", reinterpret_cast<void*>(const_cast<char*>("datacenter")));
-            zmsg_t*     msg1     = fty_proto_encode_asset(aux1, dc_name.c_str(), "inventory", nullptr);
-            std::string subject1 = "datacenter.unknown@";
-            subject.append(dc_name);
-            r = mlm_client_send(client, subject.c_str(), &msg1);
-            zhash_destroy(&aux1);
-            if (r != 0) {
-                mlm_client_destroy(&client);
-                return unexpected("mlm_client_send () failed.");
-            }
+        if (oneRow.first.subtypeId == persist::asset_subtype::UPS && !parents.empty()) {
+            upsDatacenters.emplace(parents.back().id, parents.back().name);
+        }
+    }
+
+    // data for uptime, one inventory message per datacenter
+    db::Topology::Filter upsFilter;
+    upsFilter.types    = {persist::asset_type::DEVICE};
+    upsFilter.subtypes = {persist::asset_subtype::UPS};
+    upsFilter.status   = "active";
+
+    for (const auto& [dcId, dcName] : upsDatacenters) {
+        auto upses = topology.descendants(dcId, upsFilter);
+
+        zhash_t* aux = zhash_new();
+        zhash_autofree(aux);
+        for (size_t i = 0; i < upses.size(); ++i) {
+            zhash_insert(aux, fmt::format("ups{}", i).c_str(), voidify(upses[i].name));
+        }
+        zhash_update(aux, "type", const_cast<char*>("datacenter"));
+
+        zmsg_t*     msg     = fty_proto_encode_asset(aux, dcName.c_str(), "inventory", nullptr);
+        std::string subject = "datacenter.unknown@" + dcName;
+        zhash_destroy(&aux);
+        if (!publisher.publish(subject, &msg)) {
+            return unexpected("Asset publisher is stopped");
         }
     }
 
-    zclock_sleep(500); // ensure that everything was send before we destroy the client
-    mlm_client_destroy(&client);
     return {};
 }
 
-Expected<void> sendConfigure(
-    const db::AssetElement& row, persist::asset_operation actionType, const std::string& agentName)
+Expected<void> sendConfigure(const db::AssetElement& row, persist::asset_operation actionType)
 {
-    return sendConfigure({std::make_pair(row, actionType)}, agentName);
+    return sendConfigure({std::make_pair(row, actionType)});
 }
 
 std::string generateMlmClientId(const std::string& client_name)
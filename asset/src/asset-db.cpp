@@ -1,192 +1,347 @@
 #include "asset/asset-db.h"
+#include "asset/asset-names.h"
+#include "asset/asset-topology.h"
 #include "asset/db.h"
 #include "asset/error.h"
 #include "asset/logger.h"
 #include <fty/split.h>
 #include <fty/translate.h>
 #include <fty_common_asset_types.h>
+#include <map>
+#include <set>
+#include <tuple>
 
 
 namespace fty::asset::db {
 
 // =====================================================================================================================
 
+// clang-format off
+static const auto webAssetMapper = tnt::rowMapper<WebAssetElement>(
+    tnt::column("v.id",             "id",           &WebAssetElement::id),
+    tnt::column("v.name",           "name",         &WebAssetElement::name),
+    tnt::column("ext.value",        "extName",      &WebAssetElement::extName),
+    tnt::column("v.id_type",        "typeId",       &WebAssetElement::typeId),
+    tnt::column("v.type_name",      "typeName",     &WebAssetElement::typeName),
+    tnt::column("v.subtype_id",     "subTypeId",    &WebAssetElement::subtypeId),
+    tnt::column("v.subtype_name",   "subTypeName",  &WebAssetElement::subtypeName),
+    tnt::column("v.id_parent",      "parentId",     &WebAssetElement::parentId),
+    tnt::column("v.id_parent_type", "parentTypeId", &WebAssetElement::parentTypeId),
+    tnt::column("v.parent_name",    "parentName",   &WebAssetElement::parentName),
+    tnt::column("v.status",         "status",       &WebAssetElement::status),
+    tnt::column("v.priority",       "priority",     &WebAssetElement::priority),
+    tnt::column("v.asset_tag",      "assetTag",     &WebAssetElement::assetTag)
+);
+
+static const auto assetLinkMapper = tnt::rowMapper<DbAssetLink>(
+    tnt::column("v.id_asset_element_src",  "srcId",      &DbAssetLink::srcId),
+    tnt::column("v.id_asset_element_dest", "destId",     &DbAssetLink::destId),
+    tnt::column("v.src_name",              "srcName",    &DbAssetLink::srcName),
+    tnt::column("v.src_out",               "srcSocket",  &DbAssetLink::srcSocket),
+    tnt::column("v.dest_in",               "destSocket", &DbAssetLink::destSocket)
+);
+// clang-format on
+
 static std::string webAssetSql()
 {
-    static const std::string sql = R"(
+    static const std::string sql = fmt::format(R"(
         SELECT
-            v.id                as id,
-            v.name              as name,
-            ext.value           as extName,
-            v.id_type           as typeId,
-            v.type_name         as typeName,
-            v.subtype_id        as subTypeId,
-            v.subtype_name      as subTypeName,
-            v.id_parent         as parentId,
-            v.id_parent_type    as parentTypeId,
-            v.parent_name       as parentName,
-            v.status            as status,
-            v.priority          as priority,
-            v.asset_tag         as assetTag
+            {}
         FROM
             v_web_element v
         LEFT JOIN
                 t_bios_asset_ext_attributes AS ext
             ON
                 ext.id_asset_element = v.id AND ext.keytag = "name"
-    )";
+    )",
+        webAssetMapper.selectList());
     return sql;
 }
 
-static void fetchWebAsset(const tnt::Row& row, WebAssetElement& asset)
+static std::string assetLinkSql()
 {
-    row.get("id", asset.id);
-    row.get("name", asset.name);
-    row.get("extName", asset.extName);
-    row.get("typeId", asset.typeId);
-    row.get("typeName", asset.typeName);
-    row.get("subTypeId", asset.subtypeId);
-    row.get("subTypeName", asset.subtypeName);
-    row.get("parentId", asset.parentId);
-    row.get("parentTypeId", asset.parentTypeId);
-    row.get("parentName", asset.parentName);
-    row.get("status", asset.status);
-    row.get("priority", asset.priority);
-    row.get("assetTag", asset.assetTag);
+    static const std::string sql = fmt::format(R"(
+        SELECT
+            {}
+        FROM
+            v_web_asset_link v
+    )",
+        assetLinkMapper.selectList());
+    return sql;
 }
 
 // =====================================================================================================================
 
-Expected<int64_t> nameToAssetId(const std::string& assetName)
+static std::string nameEntrySql()
 {
     static const std::string sql = R"(
         SELECT
-            id_asset_element
+            a.id_asset_element  as id,
+            a.name              as name,
+            ext.value           as extName
         FROM
-            t_bios_asset_element
-        WHERE name = :assetName
+            t_bios_asset_element AS a
+        LEFT JOIN
+                t_bios_asset_ext_attributes AS ext
+            ON
+                ext.id_asset_element = a.id_asset_element AND ext.keytag = "name"
     )";
+    return sql;
+}
+
+static NameIndex::Entry fetchNameEntry(const tnt::Row& row)
+{
+    NameIndex::Entry entry;
+    row.get("id", entry.id);
+    row.get("name", entry.name);
+    if (!row.isNull("extName")) {
+        entry.extName = row.get("extName");
+    }
+    return entry;
+}
+
+// Resolves asset identity, through the name index first, then selecting it by given condition and filling the index
+template <typename T>
+static Expected<NameIndex::Entry> selectNameEntry(const std::optional<NameIndex::Entry>& cached, const std::string& sql,
+    const std::string& argName, const T& value)
+{
+    if (cached) {
+        return *cached;
+    }
+
+    auto& index      = NameIndex::instance();
+    auto  generation = index.generation();
 
     try {
         tnt::Connection db;
 
-        auto res = db.selectRow(sql, "assetName"_p = assetName);
-
-        return res.get<int64_t>("id_asset_element");
+        auto entry = fetchNameEntry(db.selectRow(sql, tnt::Arg<T>{argName, value}));
+        index.insert(entry, generation);
+        return std::move(entry);
     } catch (const tntdb::NotFound&) {
-        return unexpected(error(Errors::ElementNotFound).format(assetName));
+        return unexpected(error(Errors::ElementNotFound).format(value));
     } catch (const std::exception& e) {
-        return unexpected(error(Errors::ExceptionForElement).format(e.what(), assetName));
+        return unexpected(error(Errors::ExceptionForElement).format(e.what(), value));
     }
 }
 
-// =====================================================================================================================
+static Expected<NameIndex::Entry> nameEntryById(uint32_t assetId)
+{
+    static const std::string sql = nameEntrySql() + R"(
+        WHERE
+            a.id_asset_element = :assetId
+    )";
 
-Expected<std::pair<std::string, std::string>> idToNameExtName(uint32_t assetId)
+    return selectNameEntry(NameIndex::instance().byId(assetId), sql, "assetId", assetId);
+}
+
+static Expected<NameIndex::Entry> nameEntryByName(const std::string& assetName)
 {
-    static std::string sql = R"(
-        SELECT asset.name, ext.value
-        FROM
-            t_bios_asset_element AS asset
-        LEFT JOIN
-            t_bios_asset_ext_attributes AS ext
-        ON
-            ext.id_asset_element = asset.id_asset_element
+    static const std::string sql = nameEntrySql() + R"(
         WHERE
-            ext.keytag = "name" AND asset.id_asset_element = :assetId
+            a.name = :assetName
     )";
 
+    return selectNameEntry(NameIndex::instance().byName(assetName), sql, "assetName", assetName);
+}
+
+static Expected<NameIndex::Entry> nameEntryByExtName(const std::string& assetExtName)
+{
+    static const std::string sql = nameEntrySql() + R"(
+        WHERE
+            ext.value = :extName
+    )";
+
+    return selectNameEntry(NameIndex::instance().byExtName(assetExtName), sql, "extName", assetExtName);
+}
+
+// Upper bound of IN list placeholders in one statement, longer lists are split
+static constexpr size_t MAX_IN_LIST_SIZE = 1024;
+
+// Calls func for consecutive chunks of keys, each one fits into an IN list
+template <typename T, typename Func>
+static void forEachChunk(const std::vector<T>& keys, Func&& func)
+{
+    for (size_t offset = 0; offset < keys.size(); offset += MAX_IN_LIST_SIZE) {
+        auto           last = keys.begin() + long(std::min(offset + MAX_IN_LIST_SIZE, keys.size()));
+        std::vector<T> chunk(keys.begin() + long(offset), last);
+        func(chunk);
+    }
+}
+
+// Resolves list of asset identities, whatever is not in the name index is selected by chunks of IN lists
+template <typename T, typename Func>
+static Expected<std::vector<NameIndex::Entry>> selectNameEntries(
+    const std::vector<T>& keys, const std::string& column, Func&& cached)
+{
+    std::vector<NameIndex::Entry> entries;
+    std::vector<T>                missing;
+    std::set<T>                   unique;
+
+    for (const auto& key : keys) {
+        if (!unique.insert(key).second) {
+            continue;
+        }
+        if (auto entry = cached(key)) {
+            entries.push_back(std::move(*entry));
+        } else {
+            missing.push_back(key);
+        }
+    }
+
+    if (missing.empty()) {
+        return std::move(entries);
+    }
+
+    auto& index      = NameIndex::instance();
+    auto  generation = index.generation();
+
     try {
         tnt::Connection db;
 
-        auto res = db.selectRow(sql, "assetId"_p = assetId);
+        forEachChunk(missing, [&](const std::vector<T>& chunk) {
+            std::string sql = nameEntrySql() + fmt::format(R"(
+                WHERE
+                    {} IN ({})
+            )",
+                column, tnt::inList("key", chunk.size()));
+
+            for (const auto& row : db.prepare(sql).bindList("key", chunk).select()) {
+                auto entry = fetchNameEntry(row);
+                index.insert(entry, generation);
+                entries.push_back(std::move(entry));
+            }
+        });
 
-        return std::make_pair(res.get<std::string>("name"), res.get<std::string>("value"));
-    } catch (const tntdb::NotFound&) {
-        return unexpected(error(Errors::ElementNotFound).format(assetId));
+        return std::move(entries);
     } catch (const std::exception& e) {
-        return unexpected(error(Errors::ExceptionForElement).format(e.what(), assetId));
+        return unexpected(e.what());
     }
 }
 
 // =====================================================================================================================
 
-Expected<std::string> nameToExtName(std::string assetName)
+Expected<int64_t> nameToAssetId(const std::string& assetName)
 {
-    static const std::string sql = R"(
-        SELECT e.value
-        FROM t_bios_asset_ext_attributes AS e
-        INNER JOIN t_bios_asset_element AS a
-            ON a.id_asset_element = e.id_asset_element
-        WHERE keytag = 'name' AND a.name = :asset_name
-    )";
+    auto entry = nameEntryByName(assetName);
+    if (!entry) {
+        return unexpected(entry.error());
+    }
+    return entry->id;
+}
 
-    try {
-        tnt::Connection conn;
-        auto            res = conn.selectRow(sql, "asset_name"_p = assetName);
-        return res.get("value");
-    } catch (const tntdb::NotFound&) {
+// =====================================================================================================================
+
+Expected<std::pair<std::string, std::string>> idToNameExtName(uint32_t assetId)
+{
+    auto entry = nameEntryById(assetId);
+    if (!entry) {
+        return unexpected(entry.error());
+    }
+    if (!entry->extName) {
+        return unexpected(error(Errors::ElementNotFound).format(assetId));
+    }
+    return std::make_pair(entry->name, *entry->extName);
+}
+
+// =====================================================================================================================
+
+Expected<std::map<uint32_t, std::pair<std::string, std::string>>> idToNameExtName(const std::vector<uint32_t>& assetIds)
+{
+    auto entries = selectNameEntries(assetIds, "a.id_asset_element", [](uint32_t id) {
+        return NameIndex::instance().byId(id);
+    });
+
+    if (!entries) {
+        return unexpected(entries.error());
+    }
+
+    std::map<uint32_t, std::pair<std::string, std::string>> names;
+    for (const auto& entry : *entries) {
+        if (entry.extName) {
+            names.emplace(entry.id, std::make_pair(entry.name, *entry.extName));
+        }
+    }
+    return std::move(names);
+}
+
+// =====================================================================================================================
+
+Expected<std::string> nameToExtName(std::string assetName)
+{
+    auto entry = nameEntryByName(assetName);
+    if (!entry) {
+        return unexpected(entry.error());
+    }
+    if (!entry->extName) {
         return unexpected(error(Errors::ElementNotFound).format(assetName));
-    } catch (const std::exception& e) {
-        return unexpected(error(Errors::ExceptionForElement).format(e.what(), assetName));
     }
+    return *entry->extName;
 }
 
 // =====================================================================================================================
 
-Expected<std::string> extNameToAssetName(const std::string& assetExtName)
+Expected<std::map<std::string, std::string>> nameToExtName(const std::vector<std::string>& assetNames)
 {
-    static const std::string sql = R"(
-        SELECT a.name
-        FROM t_bios_asset_element AS a
-        INNER JOIN
-            t_bios_asset_ext_attributes AS e
-        ON
-            a.id_asset_element = e.id_asset_element
-        WHERE
-            keytag = "name" and value = :extName
-    )";
+    auto entries = selectNameEntries(assetNames, "a.name", [](const std::string& name) {
+        return NameIndex::instance().byName(name);
+    });
 
-    try {
-        tnt::Connection db;
+    if (!entries) {
+        return unexpected(entries.error());
+    }
 
-        auto res = db.selectRow(sql, "extName"_p = assetExtName);
+    std::map<std::string, std::string> names;
+    for (const auto& entry : *entries) {
+        if (entry.extName) {
+            names.emplace(entry.name, *entry.extName);
+        }
+    }
+    return std::move(names);
+}
 
-        return res.get("name");
-    } catch (const tntdb::NotFound&) {
-        return unexpected(error(Errors::ElementNotFound).format(assetExtName));
-    } catch (const std::exception& e) {
-        return unexpected(error(Errors::ExceptionForElement).format(e.what(), assetExtName));
+// =====================================================================================================================
+
+Expected<std::string> extNameToAssetName(const std::string& assetExtName)
+{
+    auto entry = nameEntryByExtName(assetExtName);
+    if (!entry) {
+        return unexpected(entry.error());
     }
+    return entry->name;
 }
 
 // =====================================================================================================================
 
 Expected<int64_t> extNameToAssetId(const std::string& assetExtName)
 {
-    static const std::string sql = R"(
-        SELECT
-            a.id_asset_element
-        FROM
-            t_bios_asset_element AS a
-        INNER JOIN
-            t_bios_asset_ext_attributes AS e
-        ON
-            a.id_asset_element = e.id_asset_element
-        WHERE
-            keytag = 'name' and value = :extName
-    )";
-    try {
-        tnt::Connection db;
+    auto entry = nameEntryByExtName(assetExtName);
+    if (!entry) {
+        return unexpected(entry.error());
+    }
+    return entry->id;
+}
 
-        auto res = db.selectRow(sql, "extName"_p = assetExtName);
+// =====================================================================================================================
 
-        return res.get<int64_t>("id_asset_element");
-    } catch (const tntdb::NotFound&) {
-        return unexpected(error(Errors::ElementNotFound).format(assetExtName));
-    } catch (const std::exception& e) {
-        return unexpected(error(Errors::ExceptionForElement).format(e.what(), assetExtName));
+Expected<std::vector<NameIndex::Entry>> resolveAssetNames(const std::vector<std::string>& names)
+{
+    auto entries = selectNameEntries(names, "a.name", [](const std::string& name) {
+        return NameIndex::instance().byName(name);
+    });
+    if (!entries) {
+        return unexpected(entries.error());
     }
+
+    auto extEntries = selectNameEntries(names, "ext.value", [](const std::string& extName) {
+        return NameIndex::instance().byExtName(extName);
+    });
+    if (!extEntries) {
+        return unexpected(extEntries.error());
+    }
+
+    entries->insert(entries->end(), extEntries->begin(), extEntries->end());
+    return std::move(*entries);
 }
 
 // =====================================================================================================================
@@ -271,7 +426,7 @@ Expected<void> selectAssetElementWebById(uint32_t elementId, WebAssetElement& as
 
         auto row = db.selectRow(sql, "id"_p = elementId);
 
-        fetchWebAsset(row, asset);
+        webAssetMapper.fetch(row, webAssetMapper.resolve(row), asset);
 
         return {};
     } catch (const tntdb::NotFound&) {
@@ -400,11 +555,13 @@ Expected<uint> deleteAssetExtAttributesWithRo(tnt::Connection& conn, uint32_t el
 
     try {
         // clang-format off
-        return conn.execute(sql,
+        auto affected = conn.execute(sql,
             "element"_p = elementId,
             "ro"_p      = readOnly
         );
         // clang-format on
+        NameIndex::instance().erase(elementId);
+        return affected;
     } catch (const std::exception& e) {
         return unexpected(error(Errors::ExceptionForElement).format(e.what(), elementId));
     }
@@ -415,36 +572,57 @@ Expected<uint> deleteAssetExtAttributesWithRo(tnt::Connection& conn, uint32_t el
 Expected<uint> insertIntoAssetExtAttributes(
     tnt::Connection& conn, uint32_t elementId, const std::map<std::string, std::string>& attributes, bool readOnly)
 {
-    const std::string sql = fmt::format(R"(
+    if (attributes.empty()) {
+        return unexpected("no attributes to insert"_tr);
+    }
+
+    std::vector<AssetExtAttribute> rows;
+    for (const auto& [keytag, value] : attributes) {
+        rows.push_back({elementId, keytag, value, readOnly});
+    }
+    return insertIntoAssetExtAttributes(conn, rows);
+}
+
+Expected<uint> insertIntoAssetExtAttributes(tnt::Connection& conn, const std::vector<AssetExtAttribute>& attributes)
+{
+    static const std::string sql = R"(
         INSERT INTO
             t_bios_asset_ext_attributes (keytag, value, id_asset_element, read_only)
         VALUES
             {}
         ON DUPLICATE KEY UPDATE
             id_asset_ext_attribute = LAST_INSERT_ID(id_asset_ext_attribute)
-    )",
-        tnt::multiInsert({"keytag", "value", "id_asset_element", "read_only"}, attributes.size()));
-
-    if (attributes.empty()) {
-        return unexpected("no attributes to insert"_tr);
-    }
+    )";
 
+    uint32_t elementId = 0;
     try {
-        auto st = conn.prepare(sql);
-
-        size_t count = 0;
-        for (const auto& [key, value] : attributes) {
-            // clang-format off
-            st.bindMulti(count++,
-                "keytag"_p           = key,
-                "value"_p            = value,
-                "id_asset_element"_p = elementId,
-                "read_only"_p        = readOnly
-            );
-            // clang-format on
+        uint affected = 0;
+        auto it       = attributes.begin();
+        for (size_t batch : tnt::batchSizes(attributes.size())) {
+            auto st = conn.prepare(
+                fmt::format(sql, tnt::multiInsert({"keytag", "value", "id_asset_element", "read_only"}, batch)));
+
+            for (size_t i = 0; i < batch; ++i, ++it) {
+                elementId = it->elementId;
+                // clang-format off
+                st.bindMulti(i,
+                    "keytag"_p           = it->keytag,
+                    "value"_p            = it->value,
+                    "id_asset_element"_p = it->elementId,
+                    "read_only"_p        = it->readOnly
+                );
+                // clang-format on
+            }
+
+            affected += st.execute();
         }
 
-        return st.execute();
+        for (const auto& attr : attributes) {
+            if (attr.keytag == "name") {
+                NameIndex::instance().erase(attr.elementId);
+            }
+        }
+        return affected;
     } catch (const std::exception& e) {
         return unexpected(error(Errors::ExceptionForElement).format(e.what(), elementId));
     }
@@ -484,29 +662,44 @@ Expected<uint> insertElementIntoGroups(tnt::Connection& conn, const std::set<uin
         return 0;
     }
 
-    const std::string sql = fmt::format(R"(
+    std::vector<std::pair<uint32_t, uint32_t>> relations;
+    for (uint32_t groupId : groups) {
+        relations.emplace_back(elementId, groupId);
+    }
+    return insertElementsIntoGroups(conn, relations);
+}
+
+Expected<uint> insertElementsIntoGroups(
+    tnt::Connection& conn, const std::vector<std::pair<uint32_t, uint32_t>>& relations)
+{
+    static const std::string sql = R"(
         INSERT INTO
             t_bios_asset_group_relation
             (id_asset_group, id_asset_element)
          VALUES {}
-    )",
-        tnt::multiInsert({"gid", "elementId"}, groups.size()));
+    )";
 
+    uint32_t elementId = 0;
     try {
-        auto   st    = conn.prepare(sql);
-        size_t count = 0;
-        for (uint32_t gid : groups) {
-            // clang-format off
-            st.bindMulti(count++,
-                "gid"_p       = gid,
-                "elementId"_p = elementId
-            );
-            // clang-format on
+        uint affectedRows = 0;
+        auto it           = relations.begin();
+        for (size_t batch : tnt::batchSizes(relations.size())) {
+            auto st = conn.prepare(fmt::format(sql, tnt::multiInsert({"gid", "elementId"}, batch)));
+
+            for (size_t i = 0; i < batch; ++i, ++it) {
+                elementId = it->first;
+                // clang-format off
+                st.bindMulti(i,
+                    "gid"_p       = it->second,
+                    "elementId"_p = it->first
+                );
+                // clang-format on
+            }
+
+            affectedRows += st.execute();
         }
 
-        uint affectedRows = st.execute();
-
-        if (affectedRows == groups.size()) {
+        if (affectedRows == relations.size()) {
             return affectedRows;
         } else {
             auto msg = "not all links were inserted"_tr;
@@ -576,6 +769,7 @@ Expected<uint32_t> insertIntoAssetElement(tnt::Connection& conn, const AssetElem
             );
             // clang-format on
         }
+        NameIndex::instance().erase(rowid);
 
         if (affectedRows == 0) {
             return unexpected("Something going wrong");
@@ -614,11 +808,15 @@ Expected<uint> insertIntoAssetLinks(tnt::Connection& conn, const std::vector<Ass
         return 0;
     }
 
-    uint affectedRows = 0;
-    for (auto& link : links) {
-        auto ret = insertIntoAssetLink(conn, link);
+    auto outcomes = insertAssetLinks(conn, links);
+    if (!outcomes) {
+        logError("not all links were inserted: {}", outcomes.error());
+        return unexpected("not all links were inserted");
+    }
 
-        if (ret) {
+    uint affectedRows = 0;
+    for (auto outcome : *outcomes) {
+        if (outcome != LinkOutcome::Invalid) {
             affectedRows++;
         }
     }
@@ -631,6 +829,145 @@ Expected<uint> insertIntoAssetLinks(tnt::Connection& conn, const std::vector<Ass
     }
 }
 
+Expected<std::vector<LinkOutcome>> insertAssetLinks(tnt::Connection& conn, const std::vector<AssetLink>& links)
+{
+    // Links of the batch are given as a derived table, the same checks as in insertIntoAssetLink are done for all of
+    // them at once. As the statement does not see its own rows, links given twice are filtered out before.
+    static const std::string sql = R"(
+        INSERT INTO
+            t_bios_asset_link
+            (id_asset_device_src, id_asset_device_dest, id_asset_link_type, src_out, dest_in)
+        SELECT
+            v1.id_asset_element, v2.id_asset_element, l.linktype, l.src_out, l.dest_in
+        FROM
+            ({}) AS l
+        JOIN v_bios_asset_device v1 ON v1.id_asset_element = l.src
+        JOIN v_bios_asset_device v2 ON v2.id_asset_element = l.dest
+        WHERE
+            NOT EXISTS (
+                SELECT
+                    id_link
+                FROM
+                    t_bios_asset_link v3
+                WHERE
+                    v3.id_asset_device_src = v1.id_asset_element AND
+                    v3.id_asset_device_dest = v2.id_asset_element AND
+                    v3.src_out = l.src_out AND
+                    v3.dest_in = l.dest_in
+            )
+        ORDER BY
+            l.idx
+    )";
+
+    static const std::string inserted = R"(
+        SELECT
+            id_asset_device_src, id_asset_device_dest, src_out, dest_in
+        FROM
+            t_bios_asset_link
+        WHERE
+            id_link >= :first AND
+            id_asset_device_src IN ({})
+    )";
+
+    using Key = std::tuple<uint32_t, uint32_t, std::string, std::string>;
+
+    auto keyOf = [](uint32_t src, uint32_t dest, const std::string& out, const std::string& in) {
+        return Key{src, dest, out, in};
+    };
+
+    auto derivedTable = [](size_t count) {
+        std::string out;
+        for (size_t i = 0; i < count; ++i) {
+            out += fmt::format(
+                "{}SELECT :idx_{i} AS idx, :src_{i} AS src, :dest_{i} AS dest, :linktype_{i} AS linktype, "
+                ":out_{i} AS src_out, :in_{i} AS dest_in",
+                i > 0 ? " UNION ALL " : "", fmt::arg("i", i));
+        }
+        return out;
+    };
+
+    std::vector<LinkOutcome> outcomes(links.size(), LinkOutcome::Skipped);
+
+    // Input parameters control and removal of links given twice
+    std::vector<size_t> toInsert;
+    std::set<Key>       seen;
+    for (size_t i = 0; i < links.size(); ++i) {
+        const auto& link = links[i];
+        if (link.dest == 0 || link.src == 0 || !persist::is_ok_link_type(uint8_t(link.type))) {
+            logError("ignore insert: source/destination device is not specified or wrong link type");
+            outcomes[i] = LinkOutcome::Invalid;
+            continue;
+        }
+        // Links without both ports are not protected against duplicates (NULL never matches)
+        if (!link.srcOut.empty() && !link.destIn.empty() &&
+            !seen.insert(keyOf(link.src, link.dest, link.srcOut, link.destIn)).second) {
+            continue;
+        }
+        toInsert.push_back(i);
+    }
+
+    uint32_t elementId = 0;
+    try {
+        auto it = toInsert.begin();
+        for (size_t batch : tnt::batchSizes(toInsert.size())) {
+            std::vector<size_t>   indexes(it, it + long(batch));
+            std::vector<uint32_t> sources;
+
+            auto st = conn.prepare(fmt::format(sql, derivedTable(batch)));
+            for (size_t i = 0; i < batch; ++i) {
+                const auto& link = links[indexes[i]];
+                elementId        = link.src;
+                sources.push_back(link.src);
+                // clang-format off
+                st.bindMulti(i,
+                    "idx"_p      = uint32_t(i),
+                    "src"_p      = link.src,
+                    "dest"_p     = link.dest,
+                    "linktype"_p = link.type,
+                    "out"_p      = nullable(!link.srcOut.empty(), link.srcOut),
+                    "in"_p       = nullable(!link.destIn.empty(), link.destIn)
+                );
+                // clang-format on
+            }
+            it += long(batch);
+
+            uint affected = st.execute();
+            if (affected == batch) {
+                for (size_t idx : indexes) {
+                    outcomes[idx] = LinkOutcome::Inserted;
+                }
+                continue;
+            }
+            if (affected == 0) {
+                continue;
+            }
+
+            // Partially inserted batch: find out which links were inserted, ids of the rows inserted by one statement
+            // start with the last insert id
+            std::map<Key, size_t> counts;
+            auto check = conn.prepare(fmt::format(inserted, tnt::inList("src", sources.size())));
+            check.bind("first"_p = conn.lastInsertId());
+            check.bindList("src", sources);
+            for (const auto& row : check.select()) {
+                ++counts[keyOf(row.get<uint32_t>("id_asset_device_src"), row.get<uint32_t>("id_asset_device_dest"),
+                    row.get("src_out"), row.get("dest_in"))];
+            }
+
+            for (size_t idx : indexes) {
+                const auto& link  = links[idx];
+                auto        found = counts.find(keyOf(link.src, link.dest, link.srcOut, link.destIn));
+                if (found != counts.end() && found->second > 0) {
+                    --found->second;
+                    outcomes[idx] = LinkOutcome::Inserted;
+                }
+            }
+        }
+        return outcomes;
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::ExceptionForElement).format(e.what(), elementId));
+    }
+}
+
 // =====================================================================================================================
 
 Expected<int64_t> insertIntoAssetLink(tnt::Connection& conn, const AssetLink& link)
@@ -854,41 +1191,20 @@ Expected<void> selectAssetsByContainer(tnt::Connection& conn, uint32_t elementId
         SELECT
             v.name,
             v.id_asset_element     as asset_id,
-            v.id_asset_device_type as subtype_id,
-            v.type_name            as subtype_name,
+            v.id_subtype           as subtype_id,
+            t.name                 as subtype_name,
             v.id_type              as type_id
         FROM
-            v_bios_asset_element_super_parent AS v
+            t_bios_asset_element AS v
+        LEFT JOIN t_bios_asset_device_type AS t
+            ON t.id_asset_device_type = v.id_subtype
         WHERE
-            :containerid in (
-                v.id_parent1, v.id_parent2, v.id_parent3,
-                v.id_parent4, v.id_parent5, v.id_parent6,
-                v.id_parent7, v.id_parent8, v.id_parent9,
-                v.id_parent10
-            )
+            v.id_asset_element in ({})
     )";
 
-    if (!subtypes.empty()) {
-        std::string list = implode(subtypes, ", ", [](const auto& it) {
-            return std::to_string(it);
-        });
-        select += " AND v.id_asset_device_type in (" + list + ")";
-    }
-
-    if (!types.empty()) {
-        std::string list = implode(types, ", ", [](const auto& it) {
-            return std::to_string(it);
-        });
-        select += " AND v.id_type in (" + list + ")";
-    }
-
-    if (!status.empty()) {
-        select += " AND v.status = \"" + status + "\"";
-    }
-
     if (!without.empty()) {
         if (without == "location") {
-            select += " AND v.id_parent1 is NULL ";
+            select += " AND v.id_parent is NULL ";
         } else if (without == "powerchain") {
             select += R"(
                 AND NOT EXISTS
@@ -912,17 +1228,30 @@ Expected<void> selectAssetsByContainer(tnt::Connection& conn, uint32_t elementId
                     FROM
                         t_bios_asset_ext_attributes as a
                     WHERE
-                        a.keytag=")" +
-                      without + R"(" AND v.id_asset_element = a.id_asset_element
+                        a.keytag = :without AND v.id_asset_element = a.id_asset_element
                 )
             )";
         }
     }
 
     try {
-        for (const auto& row : conn.select(select, "containerid"_p = elementId)) {
-            cb(row);
+        // Location and filters are resolved by topology, database is asked by primary keys only
+        std::vector<uint32_t> ids;
+        for (const auto& node : Topology(conn).descendants(elementId, {types, subtypes, status})) {
+            ids.push_back(node.id);
         }
+
+        forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+            auto st = conn.prepare(fmt::format(select, tnt::inList("id", chunk.size())));
+            st.bindList("id", chunk);
+            if (!without.empty() && without != "location" && without != "powerchain") {
+                st.bind("without"_p = without);
+            }
+
+            for (const auto& row : st.select()) {
+                cb(row);
+            }
+        });
         return {};
     } catch (const std::exception& e) {
         return unexpected(error(Errors::ExceptionForElement).format(e.what(), elementId));
@@ -975,17 +1304,12 @@ Expected<std::map<std::string, int>> readDeviceTypes()
 
 Expected<std::vector<DbAssetLink>> selectAssetDeviceLinksTo(uint32_t elementId, uint8_t linkTypeId)
 {
-    static const std::string sql = R"(
-        SELECT
-            v.id_asset_element_src, v.src_out, v.dest_in, v.src_name
-        FROM
-            v_web_asset_link v
+    static const std::string sql = assetLinkSql() + R"(
         WHERE
             v.id_asset_element_dest = :iddevice AND
             v.id_asset_link_type = :idlinktype
     )";
 
-
     try {
         tnt::Connection conn;
 
@@ -997,15 +1321,13 @@ Expected<std::vector<DbAssetLink>> selectAssetDeviceLinksTo(uint32_t elementId,
         // clang-format on
 
         std::vector<DbAssetLink> ret;
+        if (rows.empty()) {
+            return std::move(ret);
+        }
 
+        auto idx = assetLinkMapper.resolve(rows);
         for (const auto& row : rows) {
-            DbAssetLink link;
-            row.get("id_asset_element_src", link.srcId);
-            row.get("src_out", link.srcSocket);
-            row.get("dest_in", link.destId);
-            row.get("src_name", link.destSocket);
-
-            ret.push_back(link);
+            assetLinkMapper.fetch(row, idx, ret.emplace_back());
         }
         return std::move(ret);
     } catch (const std::exception& e) {
@@ -1040,7 +1362,7 @@ Expected<std::map<uint32_t, std::string>> selectShortElements(uint16_t typeId, u
 
         std::map<uint32_t, std::string> item;
 
-        for (auto const& row : st.select()) {
+        for (auto const& row : st.cursor()) {
             item.emplace(row.get<uint32_t>("id"), row.get("name"));
         }
 
@@ -1130,7 +1452,9 @@ Expected<uint> deleteAssetElement(tnt::Connection& conn, uint32_t elementId)
     )";
 
     try {
-        return conn.execute(sql, "element"_p = elementId);
+        auto affected = conn.execute(sql, "element"_p = elementId);
+        NameIndex::instance().erase(elementId);
+        return affected;
     } catch (const std::exception& e) {
         return unexpected(error(Errors::ExceptionForElement).format(e.what(), elementId));
     }
@@ -1206,7 +1530,216 @@ Expected<std::vector<uint32_t>> selectAssetDeviceLinksSrc(uint32_t elementId)
 
 // =====================================================================================================================
 
+// Executes statement by chunks of ids, {0} is replaced by IN list of :id placeholders
+static uint executeForIds(tnt::Connection& conn, const std::string& sql, const std::vector<uint32_t>& ids)
+{
+    uint affected = 0;
+    forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+        affected += conn.prepare(fmt::format(sql, tnt::inList("id", chunk.size()))).bindList("id", chunk).execute();
+    });
+    return affected;
+}
+
+// =====================================================================================================================
+
+Expected<std::vector<WebAssetElement>> selectAssetElementsWebByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = webAssetSql() + R"(
+        WHERE
+            v.id IN ({})
+    )";
+
+    try {
+        std::vector<WebAssetElement> list;
+        forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+            auto rows = conn.prepare(fmt::format(sql, tnt::inList("id", chunk.size()))).bindList("id", chunk).select();
+            if (rows.empty()) {
+                return;
+            }
+
+            auto idx = webAssetMapper.resolve(rows);
+            for (const auto& row : rows) {
+                webAssetMapper.fetch(row, idx, list.emplace_back());
+            }
+        });
+        return std::move(list);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::map<uint32_t, std::vector<uint32_t>>> selectAssetDeviceLinksSrc(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        SELECT
+            id_asset_device_src, id_asset_device_dest
+        FROM
+            t_bios_asset_link
+        WHERE
+            id_asset_device_src IN ({})
+    )";
+
+    try {
+        std::map<uint32_t, std::vector<uint32_t>> links;
+        forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+            auto st = conn.prepare(fmt::format(sql, tnt::inList("id", chunk.size())));
+            for (const auto& row : st.bindList("id", chunk).select()) {
+                links[row.get<uint32_t>("id_asset_device_src")].push_back(row.get<uint32_t>("id_asset_device_dest"));
+            }
+        });
+        return std::move(links);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::map<std::string, std::vector<uint32_t>>> selectKeytagOwners(
+    tnt::Connection& conn, const std::string& keytag, const std::vector<std::string>& values)
+{
+    static const std::string sql = R"(
+        SELECT
+            id_asset_element, value
+        FROM
+            t_bios_asset_ext_attributes
+        WHERE
+            keytag = :keytag AND
+            value IN ({})
+    )";
+
+    try {
+        std::map<std::string, std::vector<uint32_t>> owners;
+        forEachChunk(values, [&](const std::vector<std::string>& chunk) {
+            auto st = conn.prepare(fmt::format(sql, tnt::inList("value", chunk.size())));
+            st.bind("keytag"_p = keytag);
+            for (const auto& row : st.bindList("value", chunk).select()) {
+                owners[row.get("value")].push_back(row.get<uint32_t>("id_asset_element"));
+            }
+        });
+        return std::move(owners);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint32_t> countAssetsByType(tnt::Connection& conn, uint16_t typeId)
+{
+    static const std::string sql = R"(
+        SELECT
+            COUNT(id_asset_element) as count
+        FROM
+            t_bios_asset_element
+        WHERE
+            id_type = :typeId
+    )";
+
+    try {
+        return conn.selectRow(sql, "typeId"_p = typeId).get<uint32_t>("count");
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint> deleteAssetGroupRelations(tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        DELETE FROM
+            t_bios_asset_group_relation
+        WHERE
+            id_asset_element IN ({0}) OR
+            id_asset_group IN ({0})
+    )";
+
+    try {
+        return executeForIds(conn, sql, ids);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint> deleteAssetLinks(tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        DELETE FROM
+            t_bios_asset_link
+        WHERE
+            id_asset_device_src IN ({0}) OR
+            id_asset_device_dest IN ({0})
+    )";
+
+    try {
+        return executeForIds(conn, sql, ids);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint> deleteMonitorAssetRelations(tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        DELETE FROM
+            t_bios_monitor_asset_relation
+        WHERE
+            id_asset_element IN ({0})
+    )";
+
+    try {
+        return executeForIds(conn, sql, ids);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint> deleteAssetElements(tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        DELETE FROM
+            t_bios_asset_element
+        WHERE
+            id_asset_element IN ({0})
+    )";
+
+    try {
+        auto affected = executeForIds(conn, sql, ids);
+        for (uint32_t id : ids) {
+            NameIndex::instance().erase(id);
+        }
+        return affected;
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
 Expected<uint32_t> maxNumberOfPowerLinks()
+{
+    try {
+        tnt::Connection conn;
+        return maxNumberOfPowerLinks(conn);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint32_t> maxNumberOfPowerLinks(tnt::Connection& conn)
 {
     static const std::string sql = R"(
         SELECT
@@ -1217,8 +1750,7 @@ Expected<uint32_t> maxNumberOfPowerLinks()
     )";
 
     try {
-        tnt::Connection conn;
-        auto            res = conn.selectRow(sql);
+        auto res = conn.selectRow(sql);
         return res.get<uint32_t>("maxCount");
     } catch (const std::exception& e) {
         return unexpected(error(Errors::InternalError).format(e.what()));
@@ -1228,6 +1760,18 @@ Expected<uint32_t> maxNumberOfPowerLinks()
 // =====================================================================================================================
 
 Expected<uint32_t> maxNumberOfAssetGroups()
+{
+    try {
+        tnt::Connection conn;
+        return maxNumberOfAssetGroups(conn);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<uint32_t> maxNumberOfAssetGroups(tnt::Connection& conn)
 {
     static const std::string sql = R"(
         SELECT
@@ -1238,8 +1782,7 @@ Expected<uint32_t> maxNumberOfAssetGroups()
     )";
 
     try {
-        tnt::Connection conn;
-        auto            res = conn.selectRow(sql);
+        auto res = conn.selectRow(sql);
         return res.get<uint32_t>("maxCount");
     } catch (const std::exception& e) {
         return unexpected(error(Errors::InternalError).format(e.what()));
@@ -1249,6 +1792,18 @@ Expected<uint32_t> maxNumberOfAssetGroups()
 // =====================================================================================================================
 
 Expected<std::vector<std::string>> selectExtRwAttributesKeytags()
+{
+    try {
+        tnt::Connection conn;
+        return selectExtRwAttributesKeytags(conn);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::vector<std::string>> selectExtRwAttributesKeytags(tnt::Connection& conn)
 {
     static const std::string sql = R"(
         SELECT
@@ -1261,7 +1816,6 @@ Expected<std::vector<std::string>> selectExtRwAttributesKeytags()
     )";
 
     try {
-        tnt::Connection          conn;
         std::vector<std::string> ret;
         for (const auto& row : conn.select(sql)) {
             ret.push_back(row.get("keytag"));
@@ -1276,35 +1830,75 @@ Expected<std::vector<std::string>> selectExtRwAttributesKeytags()
 
 Expected<std::vector<WebAssetElement>> selectAssetElementAll(const std::optional<uint32_t>& dc)
 {
-    std::string sql = webAssetSql();
-    if (dc) {
-        sql += R"(
-            WHERE v.id in (
-                SELECT p.id_asset_element
-                FROM v_bios_asset_element_super_parent p
-                WHERE
-                    :containerid in ( p.id_asset_element, p.id_parent1, p.id_parent2, p.id_parent3, p.id_parent4,
-                        p.id_parent5, p.id_parent6, p.id_parent7, p.id_parent8, p.id_parent9, p.id_parent10)
-            )
-        )";
+    try {
+        tnt::Connection db;
+        return selectAssetElementAll(db, dc);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
     }
+}
 
-    try {
-        tnt::Connection              db;
-        std::vector<WebAssetElement> list;
-        tnt::Rows                    result;
-        if (dc) {
-            result = db.select(sql, "containerid"_p = *dc);
-        } else {
-            result = db.select(sql);
-        }
+// =====================================================================================================================
 
-        for (const auto& row : db.select(sql)) {
-            WebAssetElement& asset = list.emplace_back();
-            fetchWebAsset(row, asset);
+// Assets located (at any level) in the container, including the container itself. Nothing if no container is given
+static std::optional<std::unordered_set<uint32_t>> containerIds(
+    tnt::Connection& conn, const std::optional<uint32_t>& dc)
+{
+    if (!dc) {
+        return std::nullopt;
+    }
+    return Topology(conn).subtree(*dc);
+}
+
+static bool isInside(const std::optional<std::unordered_set<uint32_t>>& ids, uint32_t id)
+{
+    return !ids || ids->count(id);
+}
+
+// =====================================================================================================================
+
+Expected<std::vector<WebAssetElement>> selectAssetElementAll(tnt::Connection& db, const std::optional<uint32_t>& dc)
+{
+    std::vector<WebAssetElement> list;
+
+    auto ret = selectAssetElementAll(db, dc, [&](const WebAssetElement& el) {
+        list.push_back(el);
+        return true;
+    });
+
+    if (!ret) {
+        return unexpected(ret.error());
+    }
+    return std::move(list);
+}
+
+// =====================================================================================================================
+
+Expected<void> selectAssetElementAll(tnt::Connection& db, const std::optional<uint32_t>& dc,
+    const std::function<bool(const WebAssetElement&)>& callback)
+{
+    static const std::string sql = webAssetSql();
+
+    try {
+        auto inside = containerIds(db, dc);
+
+        std::optional<std::decay_t<decltype(webAssetMapper)>::Indexes> idx;
+        WebAssetElement                                                el;
+        for (const auto& row : db.prepare(sql).cursor()) {
+            if (!idx) {
+                idx = webAssetMapper.resolve(row);
+            }
+            el = {};
+            webAssetMapper.fetch(row, *idx, el);
+            if (!isInside(inside, el.id)) {
+                continue;
+            }
+            if (!callback(el)) {
+                break;
+            }
         }
 
-        return std::move(list);
+        return {};
     } catch (const std::exception& e) {
         return unexpected(error(Errors::InternalError).format(e.what()));
     }
@@ -1338,4 +1932,136 @@ Expected<std::vector<std::string>> selectGroupNames(uint32_t id)
 
 // =====================================================================================================================
 
+Expected<std::vector<WebAssetElement>> selectAssetElementPage(tnt::Connection& conn, uint32_t afterId, size_t limit)
+{
+    static const std::string sql = webAssetSql() + R"(
+        WHERE
+            v.id > :after
+        ORDER BY
+            v.id
+        LIMIT {}
+    )";
+
+    try {
+        auto rows = conn.prepare(fmt::format(sql, limit)).bind("after"_p = afterId).select();
+
+        std::vector<WebAssetElement> list;
+        if (rows.empty()) {
+            return std::move(list);
+        }
+
+        list.reserve(rows.size());
+        auto idx = webAssetMapper.resolve(rows);
+        for (const auto& row : rows) {
+            webAssetMapper.fetch(row, idx, list.emplace_back());
+        }
+        return std::move(list);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::map<uint32_t, Attributes>> selectExtAttributesByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        SELECT
+            v.id_asset_element,
+            v.keytag,
+            v.value,
+            v.read_only
+        FROM
+            v_bios_asset_ext_attributes v
+        WHERE
+            v.id_asset_element IN ({})
+    )";
+
+    try {
+        std::map<uint32_t, Attributes> attrs;
+        forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+            auto st = conn.prepare(fmt::format(sql, tnt::inList("id", chunk.size())));
+            for (const auto& row : st.bindList("id", chunk).select()) {
+                ExtAttrValue val;
+                row.get("value", val.value);
+                row.get("read_only", val.readOnly);
+
+                attrs[row.get<uint32_t>("id_asset_element")].emplace(row.get("keytag"), val);
+            }
+        });
+        return std::move(attrs);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::map<uint32_t, std::vector<DbAssetLink>>> selectAssetDeviceLinksToByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids, uint8_t linkTypeId)
+{
+    static const std::string sql = assetLinkSql() + R"(
+        WHERE
+            v.id_asset_link_type = :idlinktype AND
+            v.id_asset_element_dest IN ({})
+        ORDER BY
+            v.id_link
+    )";
+
+    try {
+        std::map<uint32_t, std::vector<DbAssetLink>> ret;
+        forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+            auto st = conn.prepare(fmt::format(sql, tnt::inList("id", chunk.size())));
+            st.bind("idlinktype"_p = linkTypeId);
+            auto rows = st.bindList("id", chunk).select();
+            if (rows.empty()) {
+                return;
+            }
+
+            auto        idx = assetLinkMapper.resolve(rows);
+            DbAssetLink link;
+            for (const auto& row : rows) {
+                assetLinkMapper.fetch(row, idx, link);
+                ret[link.destId].push_back(link);
+            }
+        });
+        return std::move(ret);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
+Expected<std::map<uint32_t, std::vector<uint32_t>>> selectAssetGroupsByIds(
+    tnt::Connection& conn, const std::vector<uint32_t>& ids)
+{
+    static const std::string sql = R"(
+        SELECT
+            v.id_asset_element, v.id_asset_group
+        FROM
+            v_bios_asset_group_relation v
+        WHERE
+            v.id_asset_element IN ({})
+        ORDER BY
+            v.id_asset_group_relation
+    )";
+
+    try {
+        std::map<uint32_t, std::vector<uint32_t>> ret;
+        forEachChunk(ids, [&](const std::vector<uint32_t>& chunk) {
+            auto st = conn.prepare(fmt::format(sql, tnt::inList("id", chunk.size())));
+            for (const auto& row : st.bindList("id", chunk).select()) {
+                ret[row.get<uint32_t>("id_asset_element")].push_back(row.get<uint32_t>("id_asset_group"));
+            }
+        });
+        return std::move(ret);
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::InternalError).format(e.what()));
+    }
+}
+
+// =====================================================================================================================
+
 } // namespace fty::asset::db
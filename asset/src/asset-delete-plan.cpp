@@ -0,0 +1,136 @@
+#include "asset/asset-delete-plan.h"
+#include <algorithm>
+
+namespace fty::asset {
+
+// =====================================================================================================================
+
+void DeletePlan::addCandidate(uint32_t id)
+{
+    if (m_candidates.emplace(id, Candidate{}).second) {
+        m_order.push_back(id);
+    }
+}
+
+void DeletePlan::require(uint32_t id, uint32_t blocker, const Translate& reason)
+{
+    if (id == blocker || !isCandidate(id)) {
+        return;
+    }
+
+    if (auto it = m_candidates.find(blocker); it != m_candidates.end()) {
+        it->second.dependents.emplace_back(id, reason);
+    } else {
+        m_failures.emplace_back(id, reason);
+    }
+}
+
+void DeletePlan::fail(uint32_t id, const Translate& reason)
+{
+    m_failures.emplace_back(id, reason);
+}
+
+// =====================================================================================================================
+
+void DeletePlan::build()
+{
+    static const Translate cycleError = "can't delete the asset because of cyclic dependency"_tr;
+
+    m_failed.clear();
+    m_layers.clear();
+
+    for (const auto& [id, reason] : m_failures) {
+        propagate(id, reason);
+    }
+
+    // Kahn's algorithm, blockers of an asset are always in one of the previous layers
+    std::unordered_map<uint32_t, size_t> blockers;
+    for (uint32_t id : m_order) {
+        if (!m_failed.count(id)) {
+            blockers.emplace(id, 0);
+        }
+    }
+    for (const auto& [id, count] : blockers) {
+        for (const auto& [dependent, reason] : m_candidates[id].dependents) {
+            if (auto it = blockers.find(dependent); it != blockers.end()) {
+                ++it->second;
+            }
+        }
+    }
+
+    std::vector<uint32_t> layer;
+    for (uint32_t id : m_order) {
+        if (auto it = blockers.find(id); it != blockers.end() && it->second == 0) {
+            layer.push_back(id);
+        }
+    }
+
+    size_t ordered = 0;
+    while (!layer.empty()) {
+        std::sort(layer.begin(), layer.end());
+        ordered += layer.size();
+
+        std::vector<uint32_t> next;
+        for (uint32_t id : layer) {
+            for (const auto& [dependent, reason] : m_candidates[id].dependents) {
+                if (auto it = blockers.find(dependent); it != blockers.end() && --it->second == 0) {
+                    next.push_back(dependent);
+                }
+            }
+        }
+
+        m_layers.push_back(std::move(layer));
+        layer = std::move(next);
+    }
+
+    // Whatever was not ordered waits for a cycle
+    if (ordered != blockers.size()) {
+        for (const auto& [id, count] : blockers) {
+            if (count) {
+                propagate(id, cycleError);
+            }
+        }
+    }
+}
+
+void DeletePlan::propagate(uint32_t id, const Translate& reason)
+{
+    std::vector<std::pair<uint32_t, Translate>> queue{{id, reason}};
+    while (!queue.empty()) {
+        auto [current, why] = queue.back();
+        queue.pop_back();
+
+        auto it = m_candidates.find(current);
+        if (it == m_candidates.end() || !m_failed.emplace(current, why).second) {
+            continue;
+        }
+        queue.insert(queue.end(), it->second.dependents.begin(), it->second.dependents.end());
+    }
+}
+
+// =====================================================================================================================
+
+bool DeletePlan::isCandidate(uint32_t id) const
+{
+    return m_candidates.count(id) != 0;
+}
+
+bool DeletePlan::isDeletable(uint32_t id) const
+{
+    return isCandidate(id) && !m_failed.count(id);
+}
+
+const DeletePlan::Layers& DeletePlan::layers() const
+{
+    return m_layers;
+}
+
+const Translate* DeletePlan::failure(uint32_t id) const
+{
+    auto it = m_failed.find(id);
+    return it != m_failed.end() ? &it->second : nullptr;
+}
+
+// =====================================================================================================================
+
+} // namespace fty::asset
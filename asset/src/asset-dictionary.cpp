@@ -0,0 +1,126 @@
+#include "asset/asset-dictionary.h"
+#include "asset/asset-db.h"
+#include "asset/db.h"
+#include "asset/env.h"
+
+namespace fty::asset::db {
+
+static constexpr const char* ENV_DICTIONARY_TTL     = "FTY_ASSET_DICTIONARY_TTL";
+static constexpr uint32_t    DEFAULT_DICTIONARY_TTL = 60;
+
+// =====================================================================================================================
+
+std::optional<uint16_t> Dictionary::Snapshot::typeId(const std::string& name) const
+{
+    if (auto it = types.find(name); it != types.end()) {
+        return uint16_t(it->second);
+    }
+    return std::nullopt;
+}
+
+std::optional<uint16_t> Dictionary::Snapshot::subtypeId(const std::string& name) const
+{
+    if (auto it = subtypes.find(name); it != subtypes.end()) {
+        return uint16_t(it->second);
+    }
+    if (auto it = aliases.find(name); it != aliases.end()) {
+        return uint16_t(it->second);
+    }
+    return std::nullopt;
+}
+
+// =====================================================================================================================
+
+Dictionary::Dictionary()
+    : m_ttl(envSeconds(ENV_DICTIONARY_TTL, DEFAULT_DICTIONARY_TTL))
+{
+}
+
+Dictionary& Dictionary::instance()
+{
+    static Dictionary dictionary;
+    return dictionary;
+}
+
+// =====================================================================================================================
+
+static Expected<std::string> readVersion()
+{
+    static const std::string sql = R"(
+        SELECT
+            (
+                SELECT CONCAT(COUNT(*), ':', COALESCE(SUM(CRC32(CONCAT(id_asset_element_type, '=', name))), 0))
+                FROM t_bios_asset_element_type
+            ) AS types,
+            (
+                SELECT CONCAT(COUNT(*), ':', COALESCE(SUM(CRC32(CONCAT(id_asset_device_type, '=', name))), 0))
+                FROM t_bios_asset_device_type
+            ) AS subtypes
+    )";
+
+    try {
+        tnt::Connection conn;
+
+        auto row = conn.selectRow(sql);
+        return row.get("types") + "/" + row.get("subtypes");
+    } catch (const std::exception& e) {
+        return unexpected(error(Errors::ExceptionForElement).format(e.what(), sql));
+    }
+}
+
+Expected<Dictionary::SnapshotPtr> Dictionary::snapshot()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_snapshot && m_checked && Clock::now() - *m_checked < m_ttl) {
+        return m_snapshot;
+    }
+
+    auto version = readVersion();
+    if (!version) {
+        return unexpected(version.error());
+    }
+
+    if (!m_snapshot || m_snapshot->version != *version) {
+        auto types = readElementTypes();
+        if (!types) {
+            return unexpected(types.error());
+        }
+
+        auto subtypes = readDeviceTypes();
+        if (!subtypes) {
+            return unexpected(subtypes.error());
+        }
+
+        auto snapshot      = std::make_shared<Snapshot>();
+        snapshot->version  = *version;
+        snapshot->types    = std::move(*types);
+        snapshot->subtypes = std::move(*subtypes);
+
+        // Business requirement: be able to write 'rack controller', 'RC', 'rc' as subtype == 'rack controller'
+        if (auto it = snapshot->subtypes.find("rack controller"); it != snapshot->subtypes.end()) {
+            for (const auto& alias : {"rackcontroller", "rackcontroler", "rc", "RC", "RC3"}) {
+                snapshot->aliases.emplace(alias, it->second);
+            }
+        }
+        if (auto it = snapshot->subtypes.find("patch panel"); it != snapshot->subtypes.end()) {
+            snapshot->aliases.emplace("patchpanel", it->second);
+        }
+
+        m_snapshot = std::move(snapshot);
+    }
+
+    m_checked = Clock::now();
+    return m_snapshot;
+}
+
+void Dictionary::invalidate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot.reset();
+    m_checked.reset();
+}
+
+// =====================================================================================================================
+
+} // namespace fty::asset::db
@@ -0,0 +1,447 @@
+#include "asset/asset-import-jobs.h"
+#include "asset/asset-import.h"
+#include "asset/env.h"
+#include "asset/logger.h"
+#include <algorithm>
+
+#define CREATE_MODE_CSV 2
+
+namespace fty::asset {
+
+static constexpr const char* ENV_IMPORT_CHUNK     = "FTY_ASSET_IMPORT_CHUNK";
+static constexpr size_t      DEFAULT_IMPORT_CHUNK = 64;
+
+static constexpr const char* ENV_IMPORT_WORKERS     = "FTY_ASSET_IMPORT_WORKERS";
+static constexpr size_t      DEFAULT_IMPORT_WORKERS = 4;
+
+static constexpr const char* ENV_IMPORT_PART     = "FTY_ASSET_IMPORT_PART";
+static constexpr size_t      DEFAULT_IMPORT_PART = 1024;
+
+static constexpr const char* ENV_IMPORT_MAX_ROWS     = "FTY_ASSET_IMPORT_MAX_ROWS";
+static constexpr size_t      DEFAULT_IMPORT_MAX_ROWS = 100000;
+
+static constexpr const char* ENV_IMPORT_MAX_TIME     = "FTY_ASSET_IMPORT_MAX_TIME";
+static constexpr size_t      DEFAULT_IMPORT_MAX_TIME = 0;
+
+static constexpr const char* ENV_IMPORT_JOBS     = "FTY_ASSET_IMPORT_JOBS";
+static constexpr size_t      DEFAULT_IMPORT_JOBS = 1;
+
+static constexpr const char* ENV_IMPORT_JOB_TTL     = "FTY_ASSET_IMPORT_JOB_TTL";
+static constexpr size_t      DEFAULT_IMPORT_JOB_TTL = 3600;
+
+static constexpr const char* ENV_IMPORT_MAX_JOBS     = "FTY_ASSET_IMPORT_MAX_JOBS";
+static constexpr size_t      DEFAULT_IMPORT_MAX_JOBS = 8;
+
+// Finished jobs are dropped at least this often, even if nobody submits or asks for a job
+static constexpr auto EXPIRE_PERIOD = std::chrono::seconds(60);
+
+// Count of rows written in one transaction by CSV import (FTY_ASSET_IMPORT_CHUNK, 1 writes every row separately)
+static size_t importChunkSize()
+{
+    static const size_t size = envNumber(ENV_IMPORT_CHUNK, DEFAULT_IMPORT_CHUNK);
+    return size;
+}
+
+// Count of rows of CSV document read and imported at once (FTY_ASSET_IMPORT_PART)
+static size_t importPartSize()
+{
+    static const size_t size = std::max<size_t>(envNumber(ENV_IMPORT_PART, DEFAULT_IMPORT_PART), 1);
+    return size;
+}
+
+// Count of rows imported from one CSV document (FTY_ASSET_IMPORT_MAX_ROWS, 0 is not limited)
+static size_t importMaxRows()
+{
+    static const size_t rows = envNumber(ENV_IMPORT_MAX_ROWS, DEFAULT_IMPORT_MAX_ROWS);
+    return rows;
+}
+
+// Time after which no more rows of CSV document are imported (FTY_ASSET_IMPORT_MAX_TIME in seconds, 0 is not
+// limited), the part being imported is finished
+static std::chrono::seconds importMaxTime()
+{
+    static const std::chrono::seconds time = envSeconds(ENV_IMPORT_MAX_TIME, DEFAULT_IMPORT_MAX_TIME);
+    return time;
+}
+
+// Count of threads processing independent rows of CSV import (FTY_ASSET_IMPORT_WORKERS, 1 processes the rows in file
+// order), limited by the count of cores
+static size_t importWorkers()
+{
+    static const size_t workers = std::min(envNumber(ENV_IMPORT_WORKERS, DEFAULT_IMPORT_WORKERS),
+        std::max<size_t>(std::thread::hardware_concurrency(), 1));
+    return workers;
+}
+
+// Reads the string in place
+class StringBuf : public std::streambuf
+{
+public:
+    StringBuf(std::string_view str)
+    {
+        char* data = const_cast<char*>(str.data());
+        setg(data, data, data + str.size());
+    }
+};
+
+// =====================================================================================================================
+
+CsvImport::CsvImport(std::istream& in, const std::string& user, bool sendNotify)
+    : m_in(in)
+    , m_user(user)
+    , m_sendNotify(sendNotify)
+{
+}
+
+CsvImport::CsvImport(std::string_view document, const std::string& user, bool sendNotify)
+    : m_buf(std::make_unique<StringBuf>(document))
+    , m_stream(std::make_unique<std::istream>(m_buf.get()))
+    , m_in(*m_stream)
+    , m_user(user)
+    , m_sendNotify(sendNotify)
+{
+}
+
+CsvImport::~CsvImport() = default;
+
+void CsvImport::setCancel(std::function<bool()> cancelled)
+{
+    m_cancelled = std::move(cancelled);
+}
+
+void CsvImport::setDryRun(bool dryRun)
+{
+    m_dryRun = dryRun;
+}
+
+const AssetExpected<void>& CsvImport::status() const
+{
+    return m_status;
+}
+
+const AssetManager::ImportList& CsvImport::items() const
+{
+    return m_items;
+}
+
+size_t CsvImport::rowsDone() const
+{
+    return m_done;
+}
+
+size_t CsvImport::rowsFailed() const
+{
+    return m_failed;
+}
+
+bool CsvImport::next()
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (m_finished || (m_cancelled && m_cancelled())) {
+        finish();
+        return false;
+    }
+
+    try {
+        if (!m_reader) {
+            m_reader.emplace(m_in);
+            m_started = Clock::now();
+        }
+
+        const size_t maxRows = importMaxRows();
+        const auto   maxTime = importMaxTime();
+
+        size_t rows = importPartSize();
+        if (maxRows) {
+            rows = std::min(rows, maxRows > m_offset ? maxRows - m_offset : 1);
+        }
+
+        auto part = m_reader->next(rows);
+        if (!part) {
+            m_finished = true;
+        } else if (maxRows && m_offset >= maxRows) {
+            logError("Import of CSV stopped after {} rows", m_offset);
+            stop("Import is limited to {} rows, this row and the following ones were not imported"_tr.format(maxRows)
+                     .toString());
+        } else if (maxTime.count() && Clock::now() - m_started > maxTime) {
+            logError("Import of CSV stopped after {} rows, time limit {}s is over", m_offset, maxTime.count());
+            stop("Import is limited to {} seconds, this row and the following ones were not imported"_tr
+                     .format(maxTime.count())
+                     .toString());
+        } else {
+            importPart(std::move(*part));
+        }
+    } catch (const std::invalid_argument& e) {
+        m_status = unexpected(error(Errors::BadRequestDocument).format(e.what()));
+    } catch (const std::exception& e) {
+        m_status = unexpected(error(Errors::InternalError).format(e.what()));
+    }
+
+    if (!m_status || (m_cancelled && m_cancelled()) || m_finished) {
+        finish();
+    }
+    return !m_finished;
+}
+
+// The document is not read anymore, only the results of the rows are kept
+void CsvImport::finish()
+{
+    m_finished = true;
+    m_import.reset();
+    m_csv.reset();
+    m_reader.reset();
+}
+
+void CsvImport::importPart(CsvMap&& part)
+{
+    auto csv = std::make_unique<CsvMap>(std::move(part));
+    csv->setCreateMode(CREATE_MODE_CSV);
+    csv->setCreateUser(m_user);
+    csv->setUpdateUser(m_user);
+
+    auto import = std::make_unique<Import>(*csv);
+    import->setChunkSize(importChunkSize());
+    import->setWorkers(importWorkers());
+    import->setCancel(m_cancelled);
+    import->setDryRun(m_dryRun);
+    if (m_import) {
+        import->continues(*m_import);
+    }
+
+    m_import = std::move(import);
+    m_csv    = std::move(csv);
+
+    AssetExpected<void> ret;
+    try {
+        ret = m_import->process(m_sendNotify);
+    } catch (const std::exception& e) {
+        ret = unexpected(error(Errors::InternalError).format(e.what()));
+    }
+
+    // rows processed before a failure stay written, they are reported as well
+    for (const auto& [row, el] : m_import->items()) {
+        if (el) {
+            m_items.emplace(m_offset + row, el->id);
+            ++m_done;
+        } else {
+            m_items.emplace(m_offset + row, unexpected(el.error()));
+            ++m_failed;
+        }
+    }
+
+    if (!ret) {
+        m_status = unexpected(ret.error());
+        if (!m_items.empty()) {
+            // failure is reported by the first row which was not processed, as the rows over the budget
+            size_t row = 1;
+            while (m_import->items().count(row)) {
+                ++row;
+            }
+            stop(ret.error().toString(), row);
+        }
+        return;
+    }
+    m_offset += m_csv->rows() - 1;
+}
+
+// Reports the first row which is not imported, by its line in the part being imported
+void CsvImport::stop(const std::string& reason, size_t row)
+{
+    m_items.emplace(m_offset + row, unexpected(reason));
+    ++m_failed;
+    m_finished = true;
+}
+
+// =====================================================================================================================
+
+struct ImportJobs::Job
+{
+    Job(std::string&& doc, const std::string& user, bool sendNotify)
+        : csv(std::move(doc))
+        , import(std::string_view(csv), user, sendNotify)
+    {
+    }
+
+    std::string       csv; //!< released once the job is over
+    CsvImport         import;
+    std::atomic<bool> cancelled{false};
+
+    // guarded by the mutex of the jobs
+    State             state = State::Queued;
+    Clock::time_point started;
+    Clock::time_point finished;
+};
+
+ImportJobs::ImportJobs()
+    : m_ttl(envSeconds(ENV_IMPORT_JOB_TTL, DEFAULT_IMPORT_JOB_TTL))
+    , m_maxJobs(std::max<size_t>(envNumber(ENV_IMPORT_MAX_JOBS, DEFAULT_IMPORT_MAX_JOBS), 1))
+{
+    size_t count = std::max<size_t>(envNumber(ENV_IMPORT_JOBS, DEFAULT_IMPORT_JOBS), 1);
+    for (size_t i = 0; i < count; ++i) {
+        m_threads.emplace_back(&ImportJobs::run, this);
+    }
+}
+
+ImportJobs::~ImportJobs()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+ImportJobs& ImportJobs::instance()
+{
+    static ImportJobs jobs;
+    return jobs;
+}
+
+Expected<std::string> ImportJobs::submit(std::string&& csv, const std::string& user, bool sendNotify)
+{
+    std::lock_guard lock(m_mutex);
+    expire();
+
+    size_t pending = size_t(std::count_if(m_jobs.begin(), m_jobs.end(), [](const auto& it) {
+        return it.second->state == State::Queued || it.second->state == State::Running;
+    }));
+    if (pending >= m_maxJobs) {
+        logWarn("Import job of {} rejected, {} jobs are queued or running", user, pending);
+        return unexpected("Too many import jobs are in progress, try again later"_tr);
+    }
+
+    std::string id  = std::to_string(++m_lastId);
+    auto        job = std::make_shared<Job>(std::move(csv), user, sendNotify);
+    job->import.setCancel([flag = &job->cancelled]() {
+        return flag->load();
+    });
+
+    m_jobs.emplace(id, job);
+    m_queue.push_back(job);
+    m_cond.notify_one();
+
+    logInfo("Import job {} of {} queued, {} jobs in queue", id, user, m_queue.size());
+    return id;
+}
+
+std::optional<ImportJobs::Status> ImportJobs::status(const std::string& id) const
+{
+    std::shared_ptr<const Job> job;
+    Status                     ret;
+    bool                       over = false;
+    {
+        std::lock_guard lock(m_mutex);
+        auto            it = m_jobs.find(id);
+        if (it == m_jobs.end()) {
+            return std::nullopt;
+        }
+
+        job  = it->second;
+        over = job->state != State::Queued && job->state != State::Running;
+        if (over && Clock::now() - job->finished > m_ttl) {
+            return std::nullopt;
+        }
+
+        ret.state      = job->state;
+        ret.rowsDone   = job->import.rowsDone();
+        ret.rowsFailed = job->import.rowsFailed();
+        if (job->state != State::Queued) {
+            double seconds =
+                std::chrono::duration<double>((over ? job->finished : Clock::now()) - job->started).count();
+            if (seconds > 0) {
+                ret.rowsPerSecond = double(ret.rowsDone + ret.rowsFailed) / seconds;
+            }
+        }
+    }
+
+    // results of the finished job are not changed anymore, they are copied without blocking the other jobs
+    if (over) {
+        ret.items = job->import.items();
+        if (!job->import.status()) {
+            ret.error = job->import.status().error();
+        }
+    }
+    return ret;
+}
+
+bool ImportJobs::cancel(const std::string& id)
+{
+    std::lock_guard lock(m_mutex);
+    auto            it = m_jobs.find(id);
+    if (it == m_jobs.end()) {
+        return false;
+    }
+    it->second->cancelled = true;
+    return true;
+}
+
+// Imports one part of the job at the head of the queue, unfinished job goes back to the end of the queue
+void ImportJobs::run()
+{
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cond.wait_for(lock, EXPIRE_PERIOD, [this]() {
+                return m_stop || !m_queue.empty();
+            });
+            if (m_stop) {
+                return;
+            }
+            if (m_queue.empty()) {
+                expire();
+                continue;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            if (job->state == State::Queued) {
+                job->state   = State::Running;
+                job->started = Clock::now();
+            }
+        }
+
+        bool more = job->import.next();
+
+        std::lock_guard lock(m_mutex);
+        if (more) {
+            m_queue.push_back(std::move(job));
+            m_cond.notify_one();
+            continue;
+        }
+
+        job->finished = Clock::now();
+        std::string().swap(job->csv);
+        if (!job->import.status()) {
+            job->state = State::Failed;
+        } else if (job->cancelled) {
+            job->state = State::Cancelled;
+        } else {
+            job->state = State::Finished;
+        }
+        logInfo("Import job finished: {} rows imported, {} rows failed", job->import.rowsDone(),
+            job->import.rowsFailed());
+    }
+}
+
+// Drops the jobs finished before the time to live, called with the mutex locked
+void ImportJobs::expire()
+{
+    auto now = Clock::now();
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        const Job& job  = *it->second;
+        bool       over = job.state != State::Queued && job.state != State::Running;
+        if (over && now - job.finished > m_ttl) {
+            it = m_jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// =====================================================================================================================
+
+} // namespace fty::asset
@@ -1,5 +1,7 @@
 #include "asset/asset-import.h"
 #include "asset/asset-helpers.h"
+#include "asset/asset-names.h"
+#include "asset/asset-topology.h"
 #include "asset/asset-licensing.h"
 #include "asset/csv.h"
 #include "asset/db.h"
@@ -9,7 +11,11 @@
 #include <fty_asset_activator.h>
 #include <fty_common_db_dbpath.h>
 #include <fty_log.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
 #include <regex>
+#include <thread>
 
 #define AGENT_ASSET_ACTIVATOR "etn-licensing-credits"
 
@@ -25,11 +31,115 @@ namespace fty::asset {
 //    return keys;
 //}
 
+// Writes of the rows of one chunk in bulk mode: one transaction, a savepoint per row. Ext attributes, groups and
+// power links of all the rows are inserted by multi-row statements when the chunk is flushed.
+struct Import::Chunk
+{
+    tnt::Connection  conn;
+    tnt::Transaction trans{conn, tnt::Transaction::Isolation::ReadCommitted};
+
+    std::vector<db::AssetExtAttribute>         attributes;
+    std::vector<std::pair<uint32_t, uint32_t>> groups;
+    std::vector<db::AssetLink>                 links;
+
+    // Deferred writes of the row being processed, moved to the chunk once the row is written
+    std::vector<db::AssetExtAttribute>         rowAttributes;
+    std::vector<std::pair<uint32_t, uint32_t>> rowGroups;
+    std::vector<db::AssetLink>                 rowLinks;
+
+    // Post commit actions
+    std::vector<uint32_t>                    renamed;
+    std::vector<std::pair<size_t, uint32_t>> activations;
+
+    template <typename T>
+    static void append(std::vector<T>& to, std::vector<T>& from)
+    {
+        to.insert(to.end(), std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()));
+        from.clear();
+    }
+
+    void rowWritten()
+    {
+        append(attributes, rowAttributes);
+        append(groups, rowGroups);
+        append(links, rowLinks);
+    }
+
+    void rowFailed()
+    {
+        rowAttributes.clear();
+        rowGroups.clear();
+        rowLinks.clear();
+    }
+};
+
+thread_local Import::Chunk* Import::m_chunk      = nullptr;
+thread_local Import::Names* Import::m_groupNames = nullptr;
+
+// Internal name of a new asset without the id, which is appended by the database
+static std::string internalName(uint16_t typeId, uint16_t subtypeId)
+{
+    if (typeId == persist::asset_type::DEVICE) {
+        return trimmed(persist::subtypeid_to_subtype(subtypeId));
+    }
+    return trimmed(persist::typeid_to_type(typeId));
+}
+
+bool Import::CaseLess::operator()(const std::string& l, const std::string& r) const
+{
+    return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) < std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
 Import::Import(const CsvMap& cm)
     : m_cm(cm)
 {
 }
 
+void Import::continues(const Import& previous)
+{
+    std::lock_guard<std::mutex> lock(previous.m_mutex);
+    m_rc0Row  = previous.m_rc0Row && *previous.m_rc0Row != -1 ? 0 : -1;
+    m_written = previous.m_written;
+    for (const auto& [row, el] : previous.m_el) {
+        if (el) {
+            m_written.insert(el->id);
+        }
+    }
+
+    // elements of the dry run exist only in the names of the previous parts
+    if (m_dryRun) {
+        m_names    = previous.m_names;
+        m_dryRunId = previous.m_dryRunId;
+    }
+}
+
+void Import::setDryRun(bool dryRun)
+{
+    m_dryRun = dryRun;
+}
+
+void Import::setCancel(std::function<bool()> cancelled)
+{
+    m_cancelled = std::move(cancelled);
+}
+
+bool Import::cancelled() const
+{
+    return m_cancelled && m_cancelled();
+}
+
+void Import::setChunkSize(size_t rows)
+{
+    m_chunkSize = std::max<size_t>(rows, 1);
+}
+
+void Import::setWorkers(size_t workers)
+{
+    m_workers = std::max<size_t>(workers, 1);
+}
+
 const Import::ImportResMap& Import::items() const
 {
     return m_el;
@@ -37,7 +147,15 @@ const Import::ImportResMap& Import::items() const
 
 persist::asset_operation Import::operation() const
 {
-    return m_operation;
+    // operation of the last row, as if the rows were processed in file order
+    std::lock_guard lock(m_mutex);
+    return m_operations.empty() ? persist::asset_operation::INSERT : m_operations.rbegin()->second;
+}
+
+void Import::setOperation(size_t row, persist::asset_operation operation)
+{
+    std::lock_guard lock(m_mutex);
+    m_operations[row] = operation;
 }
 
 
@@ -54,51 +172,286 @@ std::string Import::mandatoryMissing() const
     return "";
 }
 
-std::map<std::string, std::string> Import::sanitizeRowExtNames(size_t row, bool sanitize) const
+void Import::resolveColumns()
 {
-    static std::vector<std::string>    sanitizeList = {"location", "logical_asset", "power_source.", "group."};
-    std::map<std::string, std::string> result;
-    // make copy of this one line
-    for (auto title : m_cm.getTitles()) {
-        result[title] = m_cm.get(row, title);
-    }
-    if (sanitize) {
-        // sanitize ext names to t_bios_asset_element.name
-        for (auto item : sanitizeList) {
-            if (item[item.size() - 1] == '.') {
-                // iterate index .X
-                for (int i = 1; true; ++i) {
-                    std::string title = item + std::to_string(i);
-
-                    auto it = result.find(title);
-                    if (it == result.end()) {
-                        break;
-                    }
+    static const std::set<std::string> basic = {
+        "create_mode", "id", "name", "type", "sub_type", "location", "status", "priority", "asset_tag"};
+
+    m_columns          = {};
+    m_columns.id       = m_cm.findColumn("id");
+    m_columns.name     = m_cm.column("name");
+    m_columns.type     = m_cm.column("type");
+    m_columns.subtype  = m_cm.column("sub_type");
+    m_columns.location = m_cm.column("location");
+    m_columns.status   = m_cm.column("status");
+    m_columns.priority = m_cm.column("priority");
+    m_columns.assetTag = m_cm.findColumn("asset_tag");
+
+    // indexed columns are taken from 1 up to the first missing index
+    std::set<std::string> used = basic;
+    for (int i = 1; true; ++i) {
+        std::string title = "group." + std::to_string(i);
+        auto        col   = m_cm.findColumn(title);
+        if (!col) {
+            break;
+        }
+        m_columns.groups.push_back(*col);
+        used.insert(title);
+    }
 
-                    auto name = db::extNameToAssetName(it->second);
-                    if (!name) {
-                        logError(name.error());
-                    } else {
-                        logDebug("sanitized {} '{}' -> '{}'", title, it->second, *name);
-                        result[title] = *name;
-                    }
+    for (int i = 1; true; ++i) {
+        std::string index  = std::to_string(i);
+        auto        source = m_cm.findColumn("power_source." + index);
+        if (!source) {
+            break;
+        }
+        m_columns.powers.push_back(
+            {*source, m_cm.findColumn("power_plug_src." + index), m_cm.findColumn("power_input." + index)});
+        used.insert({"power_source." + index, "power_plug_src." + index, "power_input." + index});
+    }
+
+    // everything else is stored as ext attributes
+    for (const auto& title : m_cm.getTitles()) {
+        if (!used.count(title)) {
+            m_columns.ext.emplace_back(title, m_cm.column(title));
+        }
+    }
+
+    for (const std::string prefix : {"ip.", "ipv6."}) {
+        for (int i = 1; m_cm.hasTitle(prefix + std::to_string(i)); ++i) {
+            m_columns.hardware.insert(prefix + std::to_string(i));
+        }
+    }
+    m_columns.hardware.insert({"fqdn", "serial_no", "model", "manufacturer", "uuid"});
+}
+
+Expected<void> Import::resolveNames()
+{
+    static const std::vector<std::string> references = {"id", "name", "location", "logical_asset"};
+    static const std::vector<std::string> indexed    = {"group.", "power_source."};
+
+    std::vector<CsvMap::Column> columns;
+    for (const auto& title : m_cm.getTitles()) {
+        bool isReference = std::find(references.begin(), references.end(), title) != references.end();
+        for (const auto& prefix : indexed) {
+            isReference = isReference || title.rfind(prefix, 0) == 0;
+        }
+        if (isReference) {
+            columns.push_back(m_cm.column(title));
+        }
+    }
+
+    std::set<std::string, std::less<>> unique;
+    for (size_t row = 1; row != m_cm.rows(); ++row) {
+        auto cells = m_cm.row(row);
+        for (auto col : columns) {
+            if (auto value = cells[col]; !value.empty() && unique.find(value) == unique.end()) {
+                unique.emplace(value);
+            }
+        }
+    }
+
+    auto entries = db::resolveAssetNames({unique.begin(), unique.end()});
+    if (!entries) {
+        return unexpected(entries.error());
+    }
+
+    for (const auto& entry : *entries) {
+        // names changed by the previous parts of the dry run are not in the database
+        if (m_dryRun && m_names.extNames.count(entry.id)) {
+            continue;
+        }
+        m_names.byName[entry.name] = {entry.id, entry.name};
+        if (entry.extName) {
+            m_names.byExtName[*entry.extName] = {entry.id, entry.name};
+            m_names.extNames[entry.id]        = *entry.extName;
+        }
+    }
+    logDebug("{} names referenced by the document, {} assets resolved", unique.size(), m_names.byName.size());
+
+    // dry run checks the type of the updated assets without a query per row
+    if (m_dryRun && m_columns.id) {
+        std::vector<uint32_t> ids;
+        for (size_t row = 1; row != m_cm.rows(); ++row) {
+            if (auto value = m_cm.view(row, *m_columns.id); !value.empty()) {
+                if (auto found = findName(std::string(value), false)) {
+                    ids.push_back(found->id);
                 }
-            } else {
-                // simple name
-                auto it = result.find(item);
-                if (it != result.end()) {
-                    auto name = db::extNameToAssetName(it->second);
-                    if (!name) {
-                        logError(name.error());
-                    } else {
-                        logDebug("sanitized {} '{}' -> '{}'", it->first, it->second, *name);
-                        result[item] = *name;
-                    }
+            }
+        }
+
+        try {
+            tnt::Connection conn;
+            db::Topology    topology(conn);
+            topology.fetchNodes(ids);
+            for (uint32_t id : ids) {
+                if (auto node = topology.node(id)) {
+                    m_idNodes.emplace(id, std::move(*node));
                 }
             }
+        } catch (const std::exception& e) {
+            return unexpected(e.what());
+        }
+    }
+    return {};
+}
+
+void Import::rememberName(const db::AssetElement& el, const std::string& extName)
+{
+    // extended name could be changed by the row, the previous one doesn't exist anymore
+    if (auto prev = findExtName(el.id)) {
+        if (auto found = findName(*prev, true); found && found->id == el.id) {
+            dropName(*prev, true);
+        }
+    }
+
+    Names& names             = m_groupNames ? *m_groupNames : m_names;
+    names.byName[el.name]    = {el.id, el.name};
+    names.byExtName[extName] = {el.id, el.name};
+    names.extNames[el.id]    = extName;
+}
+
+void Import::forgetName(uint32_t id, const std::string& name, const std::string& extName)
+{
+    if (auto found = findName(name, false); found && found->id == id) {
+        dropName(name, false);
+    }
+    if (auto found = findName(extName, true); found && found->id == id) {
+        dropName(extName, true);
+    }
+
+    if (m_groupNames) {
+        m_groupNames->extNames[id].clear();
+    } else {
+        m_names.extNames.erase(id);
+    }
+}
+
+// Name as seen by the calling thread: the names of its group of rows first, then the names of the import
+const Import::ResolvedName* Import::findName(const std::string& name, bool ext) const
+{
+    if (m_groupNames) {
+        const auto& names = ext ? m_groupNames->byExtName : m_groupNames->byName;
+        if (auto it = names.find(name); it != names.end()) {
+            return it->second.id ? &it->second : nullptr;
+        }
+    }
+
+    const auto& names = ext ? m_names.byExtName : m_names.byName;
+    auto        it    = names.find(name);
+    return it != names.end() ? &it->second : nullptr;
+}
+
+std::optional<std::string> Import::findExtName(uint32_t id) const
+{
+    if (m_groupNames) {
+        if (auto it = m_groupNames->extNames.find(id); it != m_groupNames->extNames.end()) {
+            return it->second.empty() ? std::nullopt : std::make_optional(it->second);
+        }
+    }
+
+    if (auto it = m_names.extNames.find(id); it != m_names.extNames.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+void Import::dropName(const std::string& name, bool ext)
+{
+    if (m_groupNames) {
+        (ext ? m_groupNames->byExtName : m_groupNames->byName)[name] = {};
+    } else {
+        (ext ? m_names.byExtName : m_names.byName).erase(name);
+    }
+}
+
+// Merges the names of a group of rows processed by a thread to the names of the import
+void Import::mergeNames(Names&& names)
+{
+    auto merge = [](NameMap& from, NameMap& to) {
+        for (auto& [name, resolved] : from) {
+            if (resolved.id) {
+                to[name] = std::move(resolved);
+            } else {
+                to.erase(name);
+            }
+        }
+    };
+    merge(names.byName, m_names.byName);
+    merge(names.byExtName, m_names.byExtName);
+
+    for (auto& [id, extName] : names.extNames) {
+        if (!extName.empty()) {
+            m_names.extNames[id] = std::move(extName);
+        } else {
+            m_names.extNames.erase(id);
         }
     }
-    return result;
+}
+
+// Names which are not resolved yet (different case, asset created meanwhile...) are looked up in the database
+
+Expected<uint32_t> Import::nameToAssetId(const std::string& name) const
+{
+    if (auto found = findName(name, false)) {
+        return found->id;
+    }
+    if (m_dryRun) {
+        return unexpected(error(Errors::ElementNotFound).format(name));
+    }
+
+    if (auto id = db::nameToAssetId(name)) {
+        return uint32_t(*id);
+    } else {
+        return unexpected(id.error());
+    }
+}
+
+Expected<std::string> Import::extNameToAssetName(const std::string& extName) const
+{
+    if (auto found = findName(extName, true)) {
+        return found->name;
+    }
+    if (m_dryRun) {
+        return unexpected(error(Errors::ElementNotFound).format(extName));
+    }
+    return db::extNameToAssetName(extName);
+}
+
+Expected<uint32_t> Import::assetIdByName(const std::string& name) const
+{
+    if (auto found = findName(name, false)) {
+        return found->id;
+    }
+    if (auto found = findName(name, true)) {
+        return found->id;
+    }
+    if (m_dryRun) {
+        return unexpected(error(Errors::ElementNotFound).format(name));
+    }
+
+    if (auto el = db::selectAssetElementByName(name)) {
+        return el->id;
+    } else {
+        return unexpected(el.error());
+    }
+}
+
+std::string Import::sanitizedName(const CsvMap::RowView& cells, CsvMap::Column col, bool sanitize) const
+{
+    std::string value(cells[col]);
+    if (!sanitize) {
+        return value;
+    }
+
+    // sanitize ext name to t_bios_asset_element.name
+    auto name = extNameToAssetName(value);
+    if (!name) {
+        logError(name.error());
+        return value;
+    }
+    logDebug("sanitized '{}' -> '{}'", value, *name);
+    return *name;
 }
 
 uint16_t Import::getPriority(const std::string& s) const
@@ -157,84 +510,480 @@ AssetExpected<void> Import::process(bool checkLic)
         return unexpected(error(Errors::ParamRequired).format(m));
     }
 
-    std::set<uint32_t> ids;
+    // columns are looked up by their titles once
+    resolveColumns();
+
+    // dictionaries are the same for all the rows
+    if (auto dictionary = db::Dictionary::instance().snapshot()) {
+        m_dictionary = *dictionary;
+    } else {
+        return unexpected(error(Errors::InternalError).format(dictionary.error()));
+    }
+
+    // rackcontroller-0 can only be the first row of the document
+    if (!m_rc0Row) {
+        bool rc0 = m_cm.rows() > 1 && m_columns.id && m_cm.view(1, *m_columns.id) == "rackcontroller-0";
+        logDebug("RC-0 {}detected", rc0 ? "" : "not ");
+        m_rc0Row = rc0 ? 1 : -1;
+    }
+
+    // names referenced by the rows are resolved at once
+    if (auto resolved = resolveNames(); !resolved) {
+        return unexpected(error(Errors::InternalError).format(resolved.error()));
+    }
+
     if (checkLic) {
         if (auto limitations = getLicensingLimitation(); !limitations) {
             return unexpected(error(Errors::InternalError).format(limitations.error()));
-        } else {
-            if (!limitations->global_configurability) {
-                return unexpected(error(Errors::ActionForbidden)
-                                      .format("Asset handling"_tr, "Licensing global_configurability limit hit"_tr));
+        } else if (!limitations->global_configurability) {
+            return unexpected(
+                error(Errors::ActionForbidden).format("Asset handling"_tr, "Licensing global_configurability limit hit"_tr));
+        }
+    }
+
+    if (m_workers > 1 && !m_dryRun) {
+        processParallel(checkLic);
+    } else {
+        std::vector<size_t> rows(m_cm.rows() > 1 ? m_cm.rows() - 1 : 0);
+        std::iota(rows.begin(), rows.end(), 1);
+        processRows(rows, checkLic);
+    }
+    return {};
+}
+
+// =====================================================================================================================
+
+std::vector<std::vector<size_t>> Import::independentRows() const
+{
+    static const std::vector<std::string> references = {"location", "logical_asset"};
+    static const std::vector<std::string> indexed    = {"group.", "power_source."};
+
+    std::vector<CsvMap::Column> referenceColumns;
+    for (const auto& title : m_cm.getTitles()) {
+        bool isReference = std::find(references.begin(), references.end(), title) != references.end();
+        for (const auto& prefix : indexed) {
+            isReference = isReference || title.rfind(prefix, 0) == 0;
+        }
+        if (isReference) {
+            referenceColumns.push_back(m_cm.column(title));
+        }
+    }
+
+    // Asset the name is resolved to, or the name itself for the assets created by the document
+    auto key = [&](std::string_view view) {
+        std::string name(view);
+        if (auto found = findName(name, false)) {
+            return "#" + std::to_string(found->id);
+        }
+        if (auto found = findName(name, true)) {
+            return "#" + std::to_string(found->id);
+        }
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+            return char(std::tolower(c));
+        });
+        return lower;
+    };
+
+    std::vector<size_t> parent(m_cm.rows());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    auto find = [&](size_t row) {
+        while (parent[row] != row) {
+            parent[row] = parent[parent[row]];
+            row         = parent[row];
+        }
+        return row;
+    };
+
+    auto join = [&](size_t l, size_t r) {
+        l = find(l);
+        r = find(r);
+        if (l != r) {
+            parent[std::max(l, r)] = std::min(l, r);
+        }
+    };
+
+    // Rows which write the same asset (or the same unique asset tag) depend on each other
+    std::map<std::string, size_t> definedBy;
+    for (size_t row = 1; row < m_cm.rows(); ++row) {
+        auto                     cells = m_cm.row(row);
+        std::vector<std::string> keys  = {key(cells[m_columns.name])};
+        if (m_columns.id && !cells[*m_columns.id].empty()) {
+            keys.push_back(key(cells[*m_columns.id]));
+        }
+        if (m_columns.assetTag && !cells[*m_columns.assetTag].empty()) {
+            keys.push_back("tag:" + std::string(cells[*m_columns.assetTag]));
+        }
+
+        for (const auto& k : keys) {
+            if (auto [it, inserted] = definedBy.emplace(k, row); !inserted) {
+                join(it->second, row);
+            }
+        }
+    }
+
+    // Row depends on the rows which write its location, power sources, groups and logical asset
+    for (size_t row = 1; row < m_cm.rows(); ++row) {
+        auto cells = m_cm.row(row);
+        for (auto col : referenceColumns) {
+            if (auto value = cells[col]; !value.empty()) {
+                if (auto it = definedBy.find(key(value)); it != definedBy.end()) {
+                    join(it->second, row);
+                }
             }
+        }
+    }
 
-            for (size_t row = 1; row != m_cm.rows(); ++row) {
-                if (auto it = processRow(row, ids, true, checkLic)) {
-                    ids.insert(it->id);
-                    m_el.emplace(row, *it);
-                } else {
-                    m_el.emplace(row, unexpected(it.error()));
+    std::vector<std::vector<size_t>> groups;
+    std::map<size_t, size_t>         groupOf;
+    for (size_t row = 1; row < m_cm.rows(); ++row) {
+        auto [it, inserted] = groupOf.emplace(find(row), groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(row);
+    }
+    return groups;
+}
+
+void Import::processParallel(bool checkLic)
+{
+    auto groups = independentRows();
+
+    // biggest groups first, so the threads finish at about the same time
+    std::vector<size_t> order(groups.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return groups[l].size() > groups[r].size();
+    });
+
+    // names written by a group are seen only by the thread which processes it, until all the groups are processed
+    std::vector<Names>  names(groups.size());
+    std::atomic<size_t> next{0};
+    std::exception_ptr  failure;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < order.size(); i = next++) {
+            m_groupNames = &names[order[i]];
+            try {
+                processRows(groups[order[i]], checkLic);
+            } catch (...) {
+                std::lock_guard lock(m_mutex);
+                if (!failure) {
+                    failure = std::current_exception();
                 }
             }
+            m_groupNames = nullptr;
+        }
+    };
+
+    size_t count = std::min(m_workers, groups.size());
+    logDebug("{} rows in {} independent groups, processed by {} threads", m_cm.rows() - 1, groups.size(), count);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& group : names) {
+        mergeNames(std::move(group));
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    std::sort(m_activations.begin(), m_activations.end());
+    activateAll(std::exchange(m_activations, {}));
+}
+
+void Import::processRows(const std::vector<size_t>& rows, bool checkLic)
+{
+    std::set<uint32_t> ids;
+    if (m_chunkSize > 1 && !m_dryRun) {
+        for (auto it = rows.begin(); it != rows.end() && !cancelled();) {
+            auto last = it + long(std::min<size_t>(m_chunkSize, size_t(rows.end() - it)));
+            processChunk(it, last, ids, checkLic);
+            it = last;
+        }
+    } else {
+        for (size_t row : rows) {
+            if (cancelled()) {
+                break;
+            }
+            recordRow(row, processRow(row, ids, true, checkLic), ids);
         }
+    }
+}
+
+void Import::recordRow(size_t row, AssetExpected<db::AssetElement>&& el, std::set<uint32_t>& ids)
+{
+    std::lock_guard lock(m_mutex);
+    if (el) {
+        ids.insert(el->id);
+        rememberName(*el, m_cm.get(row, m_columns.name));
+        m_el.emplace(row, *el);
     } else {
-        for (size_t row = 1; row != m_cm.rows(); ++row) {
-            if (auto it = processRow(row, ids, true, checkLic)) {
-                ids.insert(it->id);
-                m_el.emplace(row, *it);
-            } else {
-                m_el.emplace(row, unexpected(it.error()));
+        m_el.emplace(row, unexpected(el.error()));
+    }
+}
+
+// =====================================================================================================================
+
+void Import::processChunk(RowIt first, RowIt last, std::set<uint32_t>& ids, bool checkLic)
+{
+    std::vector<std::pair<size_t, uint32_t>> activations;
+    std::vector<uint32_t>                    renamed;
+    bool                                     committed = false;
+
+    try {
+        Chunk chunk;
+        m_chunk = &chunk;
+        for (auto row = first; row != last; ++row) {
+            // rows processed so far are written, the others stay without result
+            if (cancelled()) {
+                last = row;
+                break;
+            }
+            recordRow(*row, processRow(*row, ids, true, checkLic), ids);
+        }
+        if (first == last) {
+            m_chunk = nullptr;
+            return;
+        }
+
+        auto flushed = flushChunk();
+        m_chunk      = nullptr;
+        if (flushed) {
+            chunk.trans.commit();
+            committed   = true;
+            activations = std::move(chunk.activations);
+            renamed     = std::move(chunk.renamed);
+        } else {
+            logWarn("Rows {}-{} cannot be written at once: {}", *first, *(last - 1), flushed.error());
+        }
+    } catch (const std::exception& e) {
+        m_chunk = nullptr;
+        logWarn("Rows {}-{} cannot be written at once: {}", *first, *(last - 1), e.what());
+    }
+
+    if (committed) {
+        for (uint32_t id : renamed) {
+            db::NameIndex::instance().erase(id);
+        }
+        // devices are activated once they are visible for the others
+        if (m_workers > 1) {
+            std::lock_guard lock(m_mutex);
+            m_activations.insert(m_activations.end(), activations.begin(), activations.end());
+        } else {
+            activateAll(std::move(activations));
+        }
+        return;
+    }
+
+    // Chunk was rolled back, its rows are written one by one to report the failing ones exactly
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto row = first; row != last; ++row) {
+            if (auto it = m_el.find(*row); it != m_el.end()) {
+                if (it->second) {
+                    ids.erase(it->second->id);
+                    forgetName(it->second->id, it->second->name, m_cm.get(*row, m_columns.name));
+                }
+                m_el.erase(it);
             }
         }
     }
+
+    for (auto row = first; row != last && !cancelled(); ++row) {
+        recordRow(*row, processRow(*row, ids, true, checkLic), ids);
+    }
+}
+
+Expected<void> Import::flushChunk()
+{
+    if (!m_chunk->attributes.empty()) {
+        if (auto ret = db::insertIntoAssetExtAttributes(m_chunk->conn, m_chunk->attributes); !ret) {
+            return unexpected(ret.error());
+        }
+    }
+
+    if (!m_chunk->groups.empty()) {
+        if (auto ret = db::insertElementsIntoGroups(m_chunk->conn, m_chunk->groups); !ret) {
+            return unexpected(ret.error());
+        }
+    }
+
+    if (!m_chunk->links.empty()) {
+        if (auto ret = db::insertIntoAssetLinks(m_chunk->conn, m_chunk->links); !ret) {
+            return unexpected(ret.error());
+        }
+    }
     return {};
 }
 
+// =====================================================================================================================
 
-AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<uint32_t>& ids, bool sanitize, bool checkLic)
+// Rows are written by READ COMMITTED transactions: they lock only the rows they write and read the referenced rows
+// (location, power source, group) by shared locks, without gap locks on the indexes. The groups of rows written by
+// several threads change disjoint rows, so their transactions don't wait for each other.
+template <typename Func>
+auto Import::writeRow(Func&& func)
 {
-    LOG_START;
+    static const std::string savepoint = "import_row";
 
-    logDebug("################ Row number is {}", row);
-    static const std::set<std::string> statuses = {"active", "nonactive", "spare", "retired"};
+    if (!m_chunk) {
+        tnt::Connection  conn;
+        tnt::Transaction trans(conn, tnt::Transaction::Isolation::ReadCommitted);
+
+        auto ret = func(conn);
+        if (ret) {
+            trans.commit();
+        } else {
+            trans.rollback();
+        }
+        return ret;
+    }
 
-    auto types = db::readElementTypes();
-    if (!types) {
-        return unexpected(error(Errors::InternalError).format(types.error()));
+    m_chunk->trans.savepoint(savepoint);
+
+    auto ret = func(m_chunk->conn);
+    if (ret) {
+        m_chunk->trans.release(savepoint);
+        m_chunk->rowWritten();
+    } else {
+        m_chunk->trans.rollbackTo(savepoint);
+        m_chunk->rowFailed();
     }
+    return ret;
+}
 
-    auto subtypes = db::readDeviceTypes();
-    if (!subtypes) {
-        return unexpected(error(Errors::InternalError).format(subtypes.error()));
+void Import::nameChanged(uint32_t elementId) const
+{
+    if (m_chunk) {
+        m_chunk->renamed.push_back(elementId);
+    } else {
+        db::NameIndex::instance().erase(elementId);
     }
+}
 
-    // get location, powersource etc as name from ext.name
-    auto sanitizedAssetNames = sanitizeRowExtNames(row, sanitize);
+AssetExpected<void> Import::activate(size_t row, uint32_t elementId)
+{
+    if (m_chunk) {
+        m_chunk->activations.emplace_back(row, elementId);
+        return {};
+    }
+    if (m_workers > 1) {
+        std::lock_guard lock(m_mutex);
+        m_activations.emplace_back(row, elementId);
+        return {};
+    }
+    return activateDevice(elementId);
+}
 
-    auto unusedColumns = m_cm.getTitles();
-    if (unusedColumns.empty()) {
-        return unexpected(error(Errors::BadRequestDocument).format("Cannot import empty document."_tr));
+void Import::activateAll(std::vector<std::pair<size_t, uint32_t>>&& activations)
+{
+    for (const auto& [row, id] : activations) {
+        if (auto ret = activateDevice(id); !ret) {
+            std::lock_guard lock(m_mutex);
+            m_el.erase(row);
+            m_el.emplace(row, unexpected(ret.error()));
+        }
     }
+}
 
-    int rc0 = -1;
+AssetExpected<void> Import::activateDevice(uint32_t elementId)
+{
+    // check if we may activate the device
+    try {
+        std::string         assetJson = getJsonAsset(elementId);
+        mlm::MlmSyncClient  client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
+        fty::AssetActivator activationAccessor(client);
+        activationAccessor.activate(assetJson);
+    } catch (const std::exception& e) {
+        return unexpected("licensing-err", e.what());
+    }
+    return {};
+}
 
-    {
-        std::string iname = unusedColumns.count("id") ? m_cm.get(1, "id") : "noid";
-        if ("rackcontroller-0" == iname) {
-            logDebug("RC-0 detected");
-            rc0 = 1;
-        } else {
-            logDebug("RC-0 not detected");
-            rc0 = -1;
+Expected<void> Import::insertExtAttributes(tnt::Connection& conn, uint32_t elementId,
+    const std::map<std::string, std::string>& attributes, bool readOnly) const
+{
+    if (!m_chunk) {
+        if (auto ret = db::insertIntoAssetExtAttributes(conn, elementId, attributes, readOnly); !ret) {
+            return unexpected(ret.error());
+        }
+        return {};
+    }
+
+    if (attributes.empty()) {
+        return unexpected("no attributes to insert"_tr);
+    }
+    for (const auto& [keytag, value] : attributes) {
+        m_chunk->rowAttributes.push_back({elementId, keytag, value, readOnly});
+    }
+    return {};
+}
+
+Expected<void> Import::insertGroups(tnt::Connection& conn, const std::set<uint32_t>& groups, uint32_t elementId) const
+{
+    if (!m_chunk) {
+        if (auto ret = db::insertElementIntoGroups(conn, groups, elementId); !ret) {
+            return unexpected(ret.error());
+        }
+        return {};
+    }
+
+    for (uint32_t groupId : groups) {
+        m_chunk->rowGroups.emplace_back(elementId, groupId);
+    }
+    return {};
+}
+
+Expected<void> Import::insertLinks(tnt::Connection& conn, const std::vector<db::AssetLink>& links) const
+{
+    if (!m_chunk) {
+        if (auto ret = db::insertIntoAssetLinks(conn, links); !ret) {
+            return unexpected(ret.error());
+        }
+        return {};
+    }
+
+    for (const auto& link : links) {
+        if (link.src == 0 || link.dest == 0 || !persist::is_ok_link_type(uint8_t(link.type))) {
+            return unexpected("not all links were inserted");
         }
     }
+    m_chunk->rowLinks.insert(m_chunk->rowLinks.end(), links.begin(), links.end());
+    return {};
+}
+
+// =====================================================================================================================
+
+AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<uint32_t>& ids, bool sanitize, bool checkLic)
+{
+    LOG_START;
+
+    logDebug("################ Row number is {}", row);
+    static const std::set<std::string> statuses = {"active", "nonactive", "spare", "retired"};
 
-    // remove the column 'create_mode' which is set to a different value anyway
-    if (unusedColumns.count("create_mode")) {
-        unusedColumns.erase("create_mode");
+    const auto& types    = m_dictionary->types;
+    const auto& subtypes = m_dictionary->subtypes;
+
+    if (m_cm.getTitles().empty()) {
+        return unexpected(error(Errors::BadRequestDocument).format("Cannot import empty document."_tr));
     }
 
+    auto cells = m_cm.row(row);
+    int  rc0   = *m_rc0Row;
+
+    // column 'create_mode' is not an ext attribute, it is set to a different value anyway
     // because id is definitely not an external attribute
-    auto idStr = unusedColumns.count("id") ? m_cm.get(row, "id") : "";
+    std::string idStr = m_columns.id ? std::string(cells[*m_columns.id]) : "";
     logDebug("id_str = {}, rc_0 = {}", idStr, rc0);
 
     if (rc0 != int(row) && "rackcontroller-0" == idStr && rc0 != -1) {
@@ -246,24 +995,23 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         idStr = "rackcontroller-0";
     }
 
-    unusedColumns.erase("id");
-    m_operation = persist::asset_operation::INSERT;
+    setOperation(row, persist::asset_operation::INSERT);
     uint32_t id = 0;
 
     if (!idStr.empty()) {
-        if (auto tmp = db::nameToAssetId(idStr)) {
-            id = uint32_t(*tmp);
+        if (auto tmp = nameToAssetId(idStr)) {
+            id = *tmp;
         } else {
             return unexpected(error(Errors::ElementNotFound).format(idStr));
         }
-        if (ids.count(id) == 1) {
+        if (ids.count(id) == 1 || m_written.count(id) == 1) {
             return unexpected(
                 error(Errors::BadRequestDocument).format("Element id '{}' found twice, aborting"_tr.format(idStr)));
         }
-        m_operation = persist::asset_operation::UPDATE;
+        setOperation(row, persist::asset_operation::UPDATE);
     }
 
-    auto ename = m_cm.get(row, "name");
+    std::string ename(cells[m_columns.name]);
     if (ename.empty()) {
         return unexpected(error(Errors::BadParams).format("name", "empty value"_tr, "unique, non empty value"_tr));
     }
@@ -272,7 +1020,7 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
             error(Errors::BadParams).format("name", "too long string"_tr, "unique string from 1 to 50 characters"_tr));
     }
 
-    auto nameRes = db::extNameToAssetName(ename);
+    auto nameRes = extNameToAssetName(ename);
     if (!idStr.empty() && nameRes) {
         // internal name from DB must be the same as internal name from CSV
         if (*nameRes != idStr) {
@@ -289,75 +1037,62 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
     //        return unexpected(name.error());
     //    }
     logDebug("name = '{}/{}'", ename, name);
-    unusedColumns.erase("name");
 
-    auto type = m_cm.get_strip(row, "type");
+    auto type = m_cm.get_strip(row, m_columns.type);
     logDebug("type = '{}'", type);
-    if ((*types).find(type) == (*types).end()) {
+    auto typeIdOpt = m_dictionary->typeId(type);
+    if (!typeIdOpt) {
         std::string received = type.empty() ? "empty value"_tr.toString() : type;
-        std::string expected = "[" + implode(*types, ", ", [](const auto& pair) {
+        std::string expected = "[" + implode(types, ", ", [](const auto& pair) {
             return pair.first;
         }) + "]";
         return unexpected(error(Errors::BadParams).format("type", received, expected));
     }
 
-    uint16_t typeId = uint16_t((*types)[type]);
-    unusedColumns.erase("type");
+    uint16_t typeId = *typeIdOpt;
 
-    auto status = m_cm.get_strip(row, "status");
+    auto status = m_cm.get_strip(row, m_columns.status);
     logDebug("status = '{}'", status);
     if (statuses.find(status) == statuses.end()) {
         std::string received = status.empty() ? "empty value"_tr.toString() : status;
         std::string expected = "[" + implode(statuses, ", ") + "]";
         return unexpected(error(Errors::BadParams).format("status", received, expected));
     }
-    unusedColumns.erase("status");
 
-    auto assetTag = unusedColumns.count("asset_tag") ? m_cm.get(row, "asset_tag") : "";
+    std::string assetTag = m_columns.assetTag ? std::string(cells[*m_columns.assetTag]) : "";
     logDebug("asset_tag = '{}'", assetTag);
     if (assetTag.length() > 50) {
         std::string received = "too long string"_tr;
         std::string expected = "unique string from 1 to 50 characters"_tr;
         return unexpected(error(Errors::BadParams).format("asset_tag", received, expected));
     }
-    unusedColumns.erase("asset_tag");
 
-    uint16_t priority = getPriority(m_cm.get_strip(row, "priority"));
+    uint16_t priority = getPriority(m_cm.get_strip(row, m_columns.priority));
     logDebug("priority = {}", priority);
-    unusedColumns.erase("priority");
 
-    auto location = sanitizedAssetNames["location"];
+    // get location, powersource etc as name from ext.name
+    auto location = sanitizedName(cells, m_columns.location, sanitize);
     logDebug("location = '{}'", location);
     uint32_t parentId = 0;
     if (!location.empty()) {
-        auto ret = db::selectAssetElementByName(location);
+        auto ret = assetIdByName(location);
         if (ret) {
-            parentId = ret->id;
+            parentId = *ret;
         } else {
             return unexpected(ret.error());
         }
     }
-    unusedColumns.erase("location");
 
     // Business requirement: be able to write 'rack controller', 'RC', 'rc' as subtype == 'rack controller'
-    std::map<std::string, int> localSubtypes    = *subtypes;
-    int                        rackControllerId = subtypes->find("rack controller")->second;
-    int                        patchPanelId     = subtypes->find("patch panel")->second;
-
-    localSubtypes.emplace("rackcontroller", rackControllerId);
-    localSubtypes.emplace("rackcontroler", rackControllerId);
-    localSubtypes.emplace("rc", rackControllerId);
-    localSubtypes.emplace("RC", rackControllerId);
-    localSubtypes.emplace("RC3", rackControllerId);
-
-    localSubtypes.emplace(std::make_pair("patchpanel", patchPanelId));
+    uint16_t rackControllerId = m_dictionary->subtypeId("rack controller").value_or(0);
 
-    auto subtype = m_cm.get_strip(row, "sub_type");
+    auto subtype = m_cm.get_strip(row, m_columns.subtype);
 
     logDebug("subtype = '{}'", subtype);
-    if ((type == "device") && (localSubtypes.find(subtype) == localSubtypes.cend())) {
+    auto subtypeIdOpt = m_dictionary->subtypeId(subtype);
+    if ((type == "device") && !subtypeIdOpt) {
         std::string received = subtype.empty() ? "empty value"_tr.toString() : subtype;
-        std::string expected = "[" + implode(*subtypes, ", ", [](const auto& pair) {
+        std::string expected = "[" + implode(subtypes, ", ", [](const auto& pair) {
             return pair.first;
         }) + "]";
         return unexpected(error(Errors::BadParams).format("subtype", received, expected));
@@ -371,12 +1106,36 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         return unexpected(error(Errors::ParamRequired).format("subtype (for type group)"_tr));
     }
 
-    uint16_t subtypeId = uint16_t(localSubtypes.find(subtype)->second);
-    unusedColumns.erase("sub_type");
+    uint16_t subtypeId = subtypeIdOpt.value_or(0);
 
     // now we have read all basic information about element
     // if id is set, then it is right time to check what is going on in DB
-    if (!idStr.empty()) {
+    if (!idStr.empty() && (m_dryRun || m_chunk)) {
+        // dry run uses the nodes read with the names, rows of the chunk are not visible for other connections before
+        // it is committed
+        std::optional<db::Topology::Node> node;
+        if (m_dryRun) {
+            if (auto it = m_idNodes.find(id); it != m_idNodes.end()) {
+                node = it->second;
+            }
+        } else {
+            try {
+                node = db::Topology(m_chunk->conn).node(id);
+            } catch (const std::exception& e) {
+                logError("Element {} cannot be read: {}", id, e.what());
+                return unexpected("Database failure"_tr);
+            }
+        }
+        if (!node) {
+            return unexpected(error(Errors::ElementNotFound).format(idStr));
+        }
+        if (node->typeId != typeId) {
+            return unexpected(error(Errors::BadRequestDocument).format("Changing of asset type is forbidden"_tr));
+        }
+        if (node->subtypeId != subtypeId && node->subtypeId != persist::asset_subtype::N_A) {
+            return unexpected(error(Errors::BadRequestDocument).format("Changing of asset subtype is forbidden"_tr));
+        }
+    } else if (!idStr.empty()) {
         auto elementInDb = db::selectAssetElementWebById(id);
         if (!elementInDb) {
             return unexpected(elementInDb.error());
@@ -391,29 +1150,16 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         }
     }
 
-    std::string group;
-
     // list of element ids of all groups, the element belongs to
     std::set<uint32_t> groups;
-    for (int groupIndex = 1; true; groupIndex++) {
-        std::string grpColName;
-        try {
-            // column name
-            grpColName = "group." + std::to_string(groupIndex);
-            // remove from unused
-            unusedColumns.erase(grpColName);
-            // take value
-            group = sanitizedAssetNames.at(grpColName);
-        } catch (const std::out_of_range&) {
-            // if column doesn't exist, then break the cycle
-            break;
-        }
+    for (auto col : m_columns.groups) {
+        auto group = sanitizedName(cells, col, sanitize);
         logDebug("group_name = '{}'", group);
         // if group was not specified, just skip it
         if (!group.empty()) {
             // find an id from DB
-            if (auto ret = db::selectAssetElementByName(group)) {
-                groups.insert(ret->id); // if OK, then take ID
+            if (auto ret = assetIdByName(group)) {
+                groups.insert(*ret); // if OK, then take ID
             } else {
                 return unexpected(ret.error());
             }
@@ -421,33 +1167,13 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
     }
 
     std::vector<db::AssetLink> links;
-    std::string                linkSource;
-    for (int linkIndex = 1; true; linkIndex++) {
+    for (const auto& power : m_columns.powers) {
         db::AssetLink oneLink;
-        std::string   linkColName = "";
-        try {
-            // column name
-            linkColName = "power_source." + std::to_string(linkIndex);
-            // remove from unused
-            unusedColumns.erase(linkColName);
-            // take value
-            linkSource = sanitizedAssetNames.at(linkColName);
-        } catch (const std::out_of_range&) {
-            break;
-        }
+        auto          linkSource = sanitizedName(cells, power.source, sanitize);
 
         // prevent power source being myself
         if (linkSource == ename) {
             logDebug("Ignoring power source=myself");
-            linkSource        = "";
-            auto linkColName1 = "power_plug_src." + std::to_string(linkIndex);
-            auto linkColName2 = "power_input." + std::to_string(linkIndex);
-            if (!linkColName1.empty()) {
-                unusedColumns.erase(linkColName1);
-            }
-            if (!linkColName2.empty()) {
-                unusedColumns.erase(linkColName2);
-            }
             continue;
         }
 
@@ -455,35 +1181,18 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         if (!linkSource.empty()) // if power source is not specified
         {
             // find an id from DB
-            if (auto ret = db::selectAssetElementByName(linkSource)) {
-                oneLink.src = ret->id; // if OK, then take ID
+            if (auto ret = assetIdByName(linkSource)) {
+                oneLink.src = *ret; // if OK, then take ID
             } else {
                 return unexpected(ret.error());
             }
         }
 
-        // column name
-        auto linkColName1 = "power_plug_src." + std::to_string(linkIndex);
-        try {
-            // remove from unused
-            unusedColumns.erase(linkColName1);
-            // take value
-            auto linkSource1 = m_cm.get(row, linkColName1);
-            oneLink.srcOut   = linkSource1.substr(0, 4);
-        } catch (const std::out_of_range& e) {
-            logDebug("'{}' - is missing at all", linkColName1);
-            logDebug(e.what());
-        }
-
-        // column name
-        auto linkColName2 = "power_input." + std::to_string(linkIndex);
-        try {
-            unusedColumns.erase(linkColName2);              // remove from unused
-            auto linkSource2 = m_cm.get(row, linkColName2); // take value
-            oneLink.destIn   = linkSource2.substr(0, 4);
-        } catch (const std::out_of_range& e) {
-            logDebug("'{}' - is missing at all", linkColName2);
-            logDebug(e.what());
+        if (power.plug) {
+            oneLink.srcOut = std::string(cells[*power.plug].substr(0, 4));
+        }
+        if (power.input) {
+            oneLink.destIn = std::string(cells[*power.input].substr(0, 4));
         }
 
         if (oneLink.src != 0) {
@@ -498,53 +1207,16 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
     }
 
     // sanity check, for RC-0 always skip HW attributes
-    if (rc0 == int(row) && idStr != "rackcontroller-0") {
-        int i;
-        // remove all ip.X
-        for (i = 1;; ++i) {
-            std::string what = "ip." + std::to_string(i);
-            if (unusedColumns.count(what)) {
-                unusedColumns.erase(what); // remove from unused
-            } else {
-                break;
-            }
-        }
-        // remove all ipv6.X
-        for (i = 1;; ++i) {
-            std::string what = "ipv6." + std::to_string(i);
-            if (unusedColumns.count(what)) {
-                unusedColumns.erase(what); // remove from unused
-            } else {
-                break;
-            }
-        }
-        // remove fqdn
-        if (unusedColumns.count("fqdn")) {
-            unusedColumns.erase("fqdn"); // remove from unused
-        }
-        // remove serial_no
-        if (unusedColumns.count("serial_no")) {
-            unusedColumns.erase("serial_no"); // remove from unused
-        }
-        // remove model
-        if (unusedColumns.count("model")) {
-            unusedColumns.erase("model"); // remove from unused
-        }
-        // remove manufacturer
-        if (unusedColumns.count("manufacturer")) {
-            unusedColumns.erase("manufacturer"); // remove from unused
-        }
-        // remove uuid
-        if (unusedColumns.count("uuid")) {
-            unusedColumns.erase("uuid"); // remove from unused
-        }
-    }
+    bool skipHardware = rc0 == int(row) && idStr != "rackcontroller-0";
 
     std::map<std::string, std::string> extattributes;
     extattributes["name"] = ename;
-    for (auto& key : unusedColumns) {
-        // try is not needed, because here are keys that are definitely there
-        std::string value = m_cm.get(row, key);
+    for (const auto& [key, col] : m_columns.ext) {
+        if (skipHardware && m_columns.hardware.count(key)) {
+            continue;
+        }
+
+        std::string value(cells[col]);
 
         // BIOS-1564: sanitize the date for warranty_end -- start
         if (isDate(key) && !value.empty()) {
@@ -558,9 +1230,9 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
 
         if (key == "logical_asset" && !value.empty()) {
             // check, that this asset exists
-            value = sanitizedAssetNames.at("logical_asset");
+            value = sanitizedName(cells, col, sanitize);
 
-            if (auto ret = db::selectAssetElementByName(value); !ret) {
+            if (auto ret = assetIdByName(value); !ret) {
                 return unexpected(ret.error());
             }
         } else if ((key == "calibration_offset_t" || key == "calibration_offset_h") && !value.empty()) {
@@ -635,11 +1307,16 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         extattributes["type"] = subtype;
     }
 
-    tnt::Connection conn;
-
     db::AssetElement el;
 
-    if (!idStr.empty()) {
+    if (m_dryRun) {
+        // nothing is written, new elements get ids which are not in the database
+        if (auto ret = checkWrite(idStr.empty() ? 0 : id, ename, typeId, status); !ret) {
+            return unexpected(ret.error());
+        }
+        std::lock_guard lock(m_mutex);
+        el.id = idStr.empty() ? m_dryRunId-- : id;
+    } else if (!idStr.empty()) {
         std::map<std::string, std::string> extattributesRO;
         if (m_cm.getUpdateTs() != "") {
             extattributesRO["update_ts"] = m_cm.getUpdateTs();
@@ -649,57 +1326,43 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         }
         el.id = id;
 
-        std::string errmsg = "";
         if (type != "device") {
-            tnt::Transaction trans(conn);
-
-            auto ret = updateDcRoomRowRackGroup(
-                conn, el.id, name, parentId, extattributes, status, priority, groups, assetTag, extattributesRO);
+            auto ret = writeRow([&](tnt::Connection& conn) {
+                return updateDcRoomRowRackGroup(
+                    conn, el.id, name, parentId, extattributes, status, priority, groups, assetTag, extattributesRO);
+            });
 
             if (!ret) {
-                trans.rollback();
                 return unexpected(ret.error());
-            } else {
-                trans.commit();
             }
+            nameChanged(el.id);
         } else {
             if (idStr != "rackcontroller-0") {
-                tnt::Transaction trans(conn);
-
-                auto ret = updateDevice(conn, el.id, name, parentId, extattributes, "nonactive", priority, groups,
-                    links, assetTag, extattributesRO);
+                auto ret = writeRow([&](tnt::Connection& conn) {
+                    return updateDevice(conn, el.id, name, parentId, extattributes, "nonactive", priority, groups,
+                        links, assetTag, extattributesRO);
+                });
 
                 if (!ret) {
-                    trans.rollback();
                     return unexpected(ret.error());
-                } else {
-                    trans.commit();
                 }
+                nameChanged(el.id);
 
                 if (type == "device" && status == "active" && subtypeId != rackControllerId && checkLic) {
-                    // check if we may activate the device
-                    try {
-                        std::string assetJson = getJsonAsset(el.id);
-
-                        mlm::MlmSyncClient  client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
-                        fty::AssetActivator activationAccessor(client);
-                        activationAccessor.activate(assetJson);
-                    } catch (const std::exception& e) {
-                        return unexpected("licensing-err", e.what());
+                    if (auto activated = activate(row, el.id); !activated) {
+                        return unexpected(activated.error());
                     }
                 }
             } else {
-                tnt::Transaction trans(conn);
-
-                auto ret = updateDevice(conn, el.id, name, parentId, extattributes, status, priority, groups, links,
-                    assetTag, extattributesRO);
+                auto ret = writeRow([&](tnt::Connection& conn) {
+                    return updateDevice(conn, el.id, name, parentId, extattributes, status, priority, groups, links,
+                        assetTag, extattributesRO);
+                });
 
                 if (!ret) {
-                    trans.rollback();
                     return unexpected(ret.error());
-                } else {
-                    trans.commit();
                 }
+                nameChanged(el.id);
             }
         }
     } else {
@@ -714,61 +1377,69 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
         }
 
         if (type != "device") {
-            tnt::Transaction trans(conn);
             // this is a transaction
-            auto ret = insertDcRoomRowRackGroup(
-                conn, ename, typeId, parentId, extattributes, status, priority, groups, assetTag, extattributesRO);
+            auto ret = writeRow([&](tnt::Connection& conn) {
+                return insertDcRoomRowRackGroup(
+                    conn, ename, typeId, parentId, extattributes, status, priority, groups, assetTag, extattributesRO);
+            });
 
             if (!ret) {
-                trans.rollback();
                 return unexpected(ret.error());
-            } else {
-                trans.commit();
-                el.id = *ret;
             }
+            el.id = *ret;
         } else {
             if (subtypeId != rackControllerId) {
-                tnt::Transaction trans(conn);
-
-                auto ret = insertDevice(conn, links, groups, ename, parentId, extattributes, subtypeId, "nonactive",
-                    priority, assetTag, extattributesRO);
+                auto ret = writeRow([&](tnt::Connection& conn) {
+                    return insertDevice(conn, links, groups, ename, parentId, extattributes, subtypeId, "nonactive",
+                        priority, assetTag, extattributesRO);
+                });
 
                 if (!ret) {
-                    trans.rollback();
                     return unexpected(ret.error());
                 }
-                trans.commit();
                 el.id = *ret;
 
                 if (type == "device" && status == "active" && subtypeId != rackControllerId && checkLic) {
-                    // check if we may activate the device
-                    try {
-                        std::string         assetJson = getJsonAsset(el.id);
-                        mlm::MlmSyncClient  client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
-                        fty::AssetActivator activationAccessor(client);
-                        activationAccessor.activate(assetJson);
-                    } catch (const std::exception& e) {
-                        return unexpected("licensing-err", e.what());
+                    if (auto activated = activate(row, el.id); !activated) {
+                        return unexpected(activated.error());
                     }
                 }
             } else {
                 // this is a transaction
-                tnt::Transaction trans(conn);
-                auto ret = insertDevice(conn, links, groups, ename, parentId, extattributes, subtypeId, status,
-                    priority, assetTag, extattributesRO);
+                auto ret = writeRow([&](tnt::Connection& conn) {
+                    return insertDevice(conn, links, groups, ename, parentId, extattributes, subtypeId, status,
+                        priority, assetTag, extattributesRO);
+                });
 
                 if (!ret) {
-                    trans.rollback();
                     return unexpected(ret.error());
                 }
-                trans.commit();
                 el.id = *ret;
             }
         }
     }
 
-    auto ret = db::extNameToAssetName(ename);
-    if (ret) {
+    if (m_dryRun) {
+        // nothing is written, new elements are named only for the rows which follow
+        if (idStr.empty()) {
+            el.name = internalName(typeId, subtypeId) + "-" + std::to_string(el.id);
+        } else {
+            auto found = findName(idStr, false);
+            el.name    = found ? found->name : idStr;
+        }
+    } else if (m_chunk) {
+        // rows of the chunk are not visible for other connections before it is committed
+        try {
+            if (auto node = db::Topology(m_chunk->conn).node(el.id)) {
+                el.name = node->name;
+            } else {
+                return unexpected(error(Errors::ElementNotFound).format(el.id));
+            }
+        } catch (const std::exception& e) {
+            logError("Name of element {} cannot be read: {}", el.id, e.what());
+            return unexpected("Database failure"_tr);
+        }
+    } else if (auto ret = extNameToAssetName(ename)) {
         el.name = *ret;
     } else {
         return unexpected("Database failure"_tr);
@@ -785,15 +1456,38 @@ AssetExpected<db::AssetElement> Import::processRow(size_t row, const std::set<ui
     return AssetExpected<db::AssetElement>(el);
 }
 
+// Checks of the written element which don't need the database, shared by the writes and the dry run
+AssetExpected<void> Import::checkWrite(
+    uint32_t elementId, const std::string& elementName, uint16_t typeId, const std::string& status) const
+{
+    if (elementId) {
+        if (elementId == 1 && status == "nonactive") {
+            auto msg = "{}: Element cannot be inactivated. Change status to 'active'."_tr.format(elementName);
+            logError(msg.toString());
+            return unexpected(msg);
+        }
+        return {};
+    }
+
+    if (extNameToAssetName(elementName)) {
+        return unexpected(
+            "Element '{}' cannot be processed because of conflict. Most likely duplicate entry."_tr.format(
+                elementName));
+    }
+    // devices are inserted inactive and activated afterwards
+    if (typeId != persist::asset_type::DEVICE && status == "nonactive") {
+        return unexpected("Element '{}' cannot be inactivated. Change status to 'active'."_tr.format(elementName));
+    }
+    return {};
+}
+
 AssetExpected<void> Import::updateDcRoomRowRackGroup(tnt::Connection& conn, uint32_t elementId,
     const std::string& elementName, uint32_t parentId, const std::map<std::string, std::string>& extattributes,
     const std::string& status, uint16_t priority, const std::set<uint32_t>& groups, const std::string& assetTag,
     const std::map<std::string, std::string>& extattributesRO) const
 {
-    if (elementId == 1 && status == "nonactive") {
-        auto msg = "{}: Element cannot be inactivated. Change status to 'active'."_tr.format(elementName);
-        logError(msg.toString());
-        return unexpected(msg);
+    if (auto ret = checkWrite(elementId, elementName, 0, status); !ret) {
+        return unexpected(ret.error());
     }
 
 
@@ -817,7 +1511,7 @@ AssetExpected<void> Import::updateDcRoomRowRackGroup(tnt::Connection& conn, uint
     }
 
     {
-        auto ret = db::insertIntoAssetExtAttributes(conn, elementId, extattributes, false);
+        auto ret = insertExtAttributes(conn, elementId, extattributes, false);
         if (!ret) {
             logError(ret.error());
             return unexpected(ret.error());
@@ -825,7 +1519,7 @@ AssetExpected<void> Import::updateDcRoomRowRackGroup(tnt::Connection& conn, uint
     }
 
     if (!extattributesRO.empty()) {
-        auto ret = db::insertIntoAssetExtAttributes(conn, elementId, extattributesRO, false);
+        auto ret = insertExtAttributes(conn, elementId, extattributesRO, false);
         if (!ret) {
             logError(ret.error());
             return unexpected(ret.error());
@@ -841,8 +1535,8 @@ AssetExpected<void> Import::updateDcRoomRowRackGroup(tnt::Connection& conn, uint
     }
 
     {
-        auto ret = db::insertElementIntoGroups(conn, groups, elementId);
-        if (!ret || *ret != groups.size()) {
+        auto ret = insertGroups(conn, groups, elementId);
+        if (!ret) {
             auto errmsg = "cannot insert device into all specified groups"_tr;
             logError(errmsg);
             return unexpected(errmsg);
@@ -881,7 +1575,7 @@ AssetExpected<void> Import::updateDevice(tnt::Connection& conn, uint32_t element
     }
 
     {
-        auto ret = db::insertIntoAssetLinks(conn, linksCopy);
+        auto ret = insertLinks(conn, linksCopy);
         if (!ret) {
             auto errmsg = "cannot add new power sources"_tr;
             logError(errmsg);
@@ -897,20 +1591,13 @@ Expected<uint32_t> Import::insertDcRoomRowRackGroup(tnt::Connection& conn, const
     const std::string& status, uint16_t priority, const std::set<uint32_t>& groups, const std::string& assetTag,
     const std::map<std::string, std::string>& extattributesRO) const
 {
-
-    if (auto id = db::extNameToAssetId(elementName)) {
-        return unexpected(
-            "Element '{}' cannot be processed because of conflict. Most likely duplicate entry."_tr.format(
-                elementName));
+    if (auto ret = checkWrite(0, elementName, elementTypeId, status); !ret) {
+        return unexpected(ret.error());
     }
 
-    std::string iname = trimmed(persist::typeid_to_type(elementTypeId));
+    std::string iname = internalName(elementTypeId, 0);
     logDebug("element_name = '{}/{}'", elementName, iname);
 
-    if (status == "nonactive") {
-        return unexpected("Element '{}' cannot be inactivated. Change status to 'active'."_tr.format(elementName));
-    }
-
     uint32_t elementId;
     {
         db::AssetElement el;
@@ -932,7 +1619,7 @@ Expected<uint32_t> Import::insertDcRoomRowRackGroup(tnt::Connection& conn, const
     }
 
     {
-        auto ret = db::insertIntoAssetExtAttributes(conn, elementId, extattributes, false);
+        auto ret = insertExtAttributes(conn, elementId, extattributes, false);
         if (!ret) {
             logError("device was not inserted (fail in ext_attributes)");
             return unexpected(ret.error());
@@ -940,7 +1627,7 @@ Expected<uint32_t> Import::insertDcRoomRowRackGroup(tnt::Connection& conn, const
     }
 
     if (!extattributesRO.empty()) {
-        auto ret = db::insertIntoAssetExtAttributes(conn, elementId, extattributesRO, true);
+        auto ret = insertExtAttributes(conn, elementId, extattributesRO, true);
         if (!ret) {
             logError("device was not inserted (fail in ext_attributes)");
             return unexpected(ret.error());
@@ -948,7 +1635,7 @@ Expected<uint32_t> Import::insertDcRoomRowRackGroup(tnt::Connection& conn, const
     }
 
     {
-        auto ret = db::insertElementIntoGroups(conn, groups, elementId);
+        auto ret = insertGroups(conn, groups, elementId);
         if (!ret) {
             logInfo("end: device was not inserted (fail into groups)");
             return unexpected(ret.error());
@@ -976,13 +1663,11 @@ Expected<uint32_t> Import::insertDevice(tnt::Connection& conn, const std::vector
     const std::map<std::string, std::string>& extattributes, uint16_t assetDeviceTypeId, const std::string& status,
     uint16_t priority, const std::string& assetTag, const std::map<std::string, std::string>& extattributesRO) const
 {
-    if (auto ret = db::extNameToAssetId(elementName)) {
-        return unexpected(
-            "Element '{}' cannot be processed because of conflict. Most likely duplicate entry."_tr.format(
-                elementName));
+    if (auto ret = checkWrite(0, elementName, persist::asset_type::DEVICE, status); !ret) {
+        return unexpected(ret.error());
     }
 
-    std::string iname = trimmed(persist::subtypeid_to_subtype(assetDeviceTypeId));
+    std::string iname = internalName(persist::asset_type::DEVICE, assetDeviceTypeId);
     logDebug("  element_name = '{}/{}'", elementName, iname);
 
     uint32_t elementId;
@@ -1005,7 +1690,7 @@ Expected<uint32_t> Import::insertDevice(tnt::Connection& conn, const std::vector
     }
 
     {
-        auto ret = db::insertIntoAssetExtAttributes(conn, elementId, extattributes, false);
+        auto ret = insertExtAttributes(conn, elementId, extattributes, false);
         if (!ret) {
             logError("device was not inserted (fail in ext_attributes)");
             return unexpected(ret.error());
@@ -1013,7 +1698,7 @@ Expected<uint32_t> Import::insertDevice(tnt::Connection& conn, const std::vector
     }
 
     if (!extattributesRO.empty()) {
-        auto ret = db::insertIntoAssetExtAttributes(conn, elementId, extattributesRO, true);
+        auto ret = insertExtAttributes(conn, elementId, extattributesRO, true);
         if (!ret) {
             logError("device was not inserted (fail in ext_attributes)");
             return unexpected(ret.error());
@@ -1021,7 +1706,7 @@ Expected<uint32_t> Import::insertDevice(tnt::Connection& conn, const std::vector
     }
 
     {
-        auto ret = db::insertElementIntoGroups(conn, groups, elementId);
+        auto ret = insertGroups(conn, groups, elementId);
         if (!ret) {
             logInfo("device was not inserted (fail into groups)");
             return unexpected(ret.error());
@@ -1035,7 +1720,7 @@ Expected<uint32_t> Import::insertDevice(tnt::Connection& conn, const std::vector
     }
 
     {
-        auto ret = db::insertIntoAssetLinks(conn, linksCopy);
+        auto ret = insertLinks(conn, linksCopy);
         if (!ret) {
             logInfo("not all links were inserted (fail asset_link)");
             return unexpected(ret.error());
@@ -1,14 +1,56 @@
 #include "asset/asset-licensing.h"
+#include "asset/asset-configure-inform.h"
+#include "asset/env.h"
+#include "asset/logger.h"
 #include <zmq.h>
 #include <fty_common_mlm_tntmlm.h>
+#include <fty_common_mlm_utils.h>
 #include <fty_proto.h>
 #include <fty/translate.h>
 #include <fty/expected.h>
+#include <malamute.h>
 
 namespace fty::asset {
 
+static constexpr const char* ENV_LICENSING_TTL     = "FTY_ASSET_LICENSING_TTL";
+static constexpr size_t      DEFAULT_LICENSING_TTL = 60;
 
-AssetExpected<LimitationsStruct> getLicensingLimitation()
+// Failed query is repeated after this time even if nobody asks for the limitations
+static constexpr auto QUERY_RETRY = std::chrono::seconds(5);
+// Callers without cached limitations wait for the query at most this time, the query waits 30s for the reply
+static constexpr auto QUERY_WAIT = std::chrono::seconds(35);
+// Announcements are polled with this timeout, so the thread notices expired limitations and stop() in time
+static constexpr int  POLL_TIMEOUT  = 1000;
+static constexpr auto CONNECT_RETRY = std::chrono::seconds(5);
+
+// Sets the limitation given by a metric of rackcontroller-0
+// @return false if the metric is not a limitation
+static bool setLimitation(
+    const std::string& asset, const std::string& type, const std::string& value, LimitationsStruct& limitations)
+{
+    if (asset != "rackcontroller-0") {
+        return false;
+    }
+    if (type == "power_nodes.max_active") {
+        limitations.max_active_power_devices = atoi(value.c_str());
+        log_debug("limitations.max_active_power_device set to %i", limitations.max_active_power_devices);
+        return true;
+    }
+    if (type == "configurability.global") {
+        limitations.global_configurability = atoi(value.c_str());
+        log_debug("limitations.global_configurability set to %i", limitations.global_configurability);
+        return true;
+    }
+    return false;
+}
+
+static std::string str(const char* value)
+{
+    return value ? value : "";
+}
+
+// Queries the limitations from the licensing agent
+static AssetExpected<LimitationsStruct> queryLimitations()
 {
     LimitationsStruct limitations;
 
@@ -46,14 +88,8 @@ AssetExpected<LimitationsStruct> getLicensingLimitation()
         while (submsg) {
             fty_proto_t *submetric = fty_proto_decode(&submsg);
             assert (fty_proto_id(submetric) == FTY_PROTO_METRIC);
-            if (streq (fty_proto_name(submetric), "rackcontroller-0") && streq (fty_proto_type(submetric), "power_nodes.max_active")) {
-                limitations.max_active_power_devices = atoi(fty_proto_value (submetric));
-                log_debug("limitations.max_active_power_device set to %i", limitations.max_active_power_devices);
-            }
-            else if (streq (fty_proto_name(submetric), "rackcontroller-0") && streq (fty_proto_type(submetric), "configurability.global")) {
-                limitations.global_configurability = atoi(fty_proto_value (submetric));
-                log_debug("limitations.global_configurability set to %i", limitations.global_configurability);
-            }
+            setLimitation(
+                str(fty_proto_name(submetric)), str(fty_proto_type(submetric)), str(fty_proto_value(submetric)), limitations);
             fty_proto_destroy(&submetric);
             submsg = zmsg_popmsg(response);
         }
@@ -65,4 +101,211 @@ AssetExpected<LimitationsStruct> getLicensingLimitation()
     return limitations;
 }
 
+// =====================================================================================================================
+
+Licensing::Licensing(Query query, std::chrono::seconds ttl, bool announcements)
+    : m_query(std::move(query))
+    , m_announcements(announcements)
+    , m_ttl(ttl)
+    , m_thread(&Licensing::run, this)
+{
 }
+
+Licensing::~Licensing()
+{
+    stop();
+}
+
+Licensing& Licensing::instance()
+{
+    static Licensing licensing(queryLimitations, envSeconds(ENV_LICENSING_TTL, DEFAULT_LICENSING_TTL), true);
+    return licensing;
+}
+
+AssetExpected<LimitationsStruct> Licensing::limitations()
+{
+    if (m_ttl.count() == 0) {
+        return m_query();
+    }
+
+    std::unique_lock lock(m_mutex);
+    if (!m_cached) {
+        // Nothing to return yet, wait for the query in progress or ask for a new one if the last one failed
+        uint64_t queries = m_queries;
+        m_refresh        = true;
+        m_cond.notify_all();
+        m_cond.wait_for(lock, QUERY_WAIT, [&]() {
+            return m_stopped || m_queries > queries;
+        });
+    } else if (refreshNeeded()) {
+        // Expired limitations are returned while the thread fetches the new ones
+        m_refresh = true;
+        m_cond.notify_all();
+    }
+
+    if (m_cached) {
+        return *m_cached;
+    }
+    if (m_error) {
+        return unexpected(*m_error);
+    }
+    return unexpected("Licensing limitations are not available"_tr);
+}
+
+void Licensing::invalidate()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_refresh = true;
+    }
+    m_cond.notify_all();
+}
+
+void Licensing::announced(const std::string& asset, const std::string& type, const std::string& value)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        // the query in progress could return the limitations before the change
+        if (!m_cached || !setLimitation(asset, type, value, *m_cached) || m_querying) {
+            m_refresh = true;
+        }
+    }
+    m_cond.notify_all();
+}
+
+void Licensing::stop()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_stopped) {
+            return;
+        }
+        m_stopped = true;
+    }
+    m_cond.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+// Must be called with the mutex locked
+bool Licensing::refreshNeeded() const
+{
+    if (m_refresh || !m_queried) {
+        return true;
+    }
+    return Clock::now() - *m_queried >= (m_cached ? m_ttl : QUERY_RETRY);
+}
+
+void Licensing::run()
+{
+    if (m_ttl.count() == 0) {
+        return;
+    }
+
+    mlm_client_t*     client = nullptr;
+    zpoller_t*        poller = nullptr;
+    Clock::time_point lastConnect;
+
+    // Announcements of the agent change the cached limitations
+    auto connect = [&]() {
+        lastConnect = Clock::now();
+
+        client = mlm_client_new();
+        if (!client) {
+            logError("mlm_client_new () failed.");
+            return;
+        }
+
+        std::string name = generateMlmClientId("web.asset_licensing");
+        if (mlm_client_connect(client, MLM_ENDPOINT, 1000, name.c_str()) == -1) {
+            logError("mlm_client_connect () failed.");
+            mlm_client_destroy(&client);
+            return;
+        }
+
+        if (mlm_client_set_consumer(client, FTY_PROTO_STREAM_LICENSING_ANNOUNCEMENTS, ".*") == -1) {
+            logError("mlm_client_set_consumer () failed.");
+            mlm_client_destroy(&client);
+            return;
+        }
+
+        poller = zpoller_new(mlm_client_msgpipe(client), nullptr);
+    };
+
+    while (true) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_stopped) {
+                break;
+            }
+        }
+
+        if (m_announcements && !client && Clock::now() - lastConnect >= CONNECT_RETRY) {
+            connect();
+        }
+
+        bool query;
+        {
+            std::lock_guard lock(m_mutex);
+            query = refreshNeeded();
+            // Announcements received during the query ask for another one
+            m_refresh  = false;
+            m_querying = query;
+        }
+
+        if (query) {
+            auto limitations = m_query();
+            {
+                std::lock_guard lock(m_mutex);
+                m_querying = false;
+                m_queried  = Clock::now();
+                ++m_queries;
+                if (limitations) {
+                    m_cached = *limitations;
+                    m_error.reset();
+                } else {
+                    logWarn("Licensing limitations cannot be fetched: {}", limitations.error().toString());
+                    m_error = limitations.error();
+                }
+            }
+            m_cond.notify_all();
+        }
+
+        if (!poller) {
+            std::unique_lock lock(m_mutex);
+            m_cond.wait_for(lock, std::chrono::milliseconds(POLL_TIMEOUT), [&]() {
+                return m_stopped || m_refresh;
+            });
+            continue;
+        }
+
+        if (zpoller_wait(poller, POLL_TIMEOUT)) {
+            zmsg_t* msg = mlm_client_recv(client);
+            if (msg && fty_proto_is(msg)) {
+                fty_proto_t* proto = fty_proto_decode(&msg);
+                if (proto && fty_proto_id(proto) == FTY_PROTO_METRIC) {
+                    announced(str(fty_proto_name(proto)), str(fty_proto_type(proto)), str(fty_proto_value(proto)));
+                } else {
+                    invalidate();
+                }
+                fty_proto_destroy(&proto);
+            } else if (msg) {
+                invalidate();
+            }
+            zmsg_destroy(&msg);
+        }
+    }
+
+    zpoller_destroy(&poller);
+    mlm_client_destroy(&client);
+}
+
+// =====================================================================================================================
+
+AssetExpected<LimitationsStruct> getLicensingLimitation()
+{
+    return Licensing::instance().limitations();
+}
+
+} // namespace fty::asset
@@ -0,0 +1,141 @@
+#include "asset/asset-names.h"
+#include "asset/env.h"
+#include <mutex>
+
+namespace fty::asset::db {
+
+static constexpr const char* ENV_NAME_INDEX_TTL     = "FTY_ASSET_NAME_INDEX_TTL";
+static constexpr uint32_t    DEFAULT_NAME_INDEX_TTL = 60;
+
+// =====================================================================================================================
+
+NameIndex::NameIndex()
+    : m_ttl(envSeconds(ENV_NAME_INDEX_TTL, DEFAULT_NAME_INDEX_TTL))
+{
+}
+
+NameIndex& NameIndex::instance()
+{
+    static NameIndex index;
+    return index;
+}
+
+// =====================================================================================================================
+
+std::optional<NameIndex::Entry> NameIndex::byId(uint32_t id) const
+{
+    std::shared_lock lock(m_mutex);
+    if (auto it = m_byId.find(id); it != m_byId.end() && isFresh(it->second)) {
+        return it->second.entry;
+    }
+    return std::nullopt;
+}
+
+std::optional<NameIndex::Entry> NameIndex::byName(const std::string& name) const
+{
+    std::shared_lock lock(m_mutex);
+    return find(m_byName, name);
+}
+
+std::optional<NameIndex::Entry> NameIndex::byExtName(const std::string& extName) const
+{
+    std::shared_lock lock(m_mutex);
+    return find(m_byExtName, extName);
+}
+
+std::optional<NameIndex::Entry> NameIndex::find(
+    const std::unordered_map<std::string, uint32_t>& index, const std::string& key) const
+{
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return std::nullopt;
+    }
+
+    if (auto rec = m_byId.find(it->second); rec != m_byId.end() && isFresh(rec->second)) {
+        return rec->second.entry;
+    }
+    return std::nullopt;
+}
+
+bool NameIndex::isFresh(const Record& rec) const
+{
+    return Clock::now() - rec.stamp < m_ttl;
+}
+
+// =====================================================================================================================
+
+uint64_t NameIndex::generation() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_generation;
+}
+
+void NameIndex::insert(const Entry& entry, uint64_t generation)
+{
+    if (m_ttl.count() == 0) {
+        return;
+    }
+
+    std::unique_lock lock(m_mutex);
+    if (generation != m_generation) {
+        return;
+    }
+
+    // Drop whatever is known about this id and about the other assets which claimed one of its names
+    eraseLocked(entry.id);
+    if (auto it = m_byName.find(entry.name); it != m_byName.end()) {
+        eraseLocked(it->second);
+    }
+    if (entry.extName) {
+        if (auto it = m_byExtName.find(*entry.extName); it != m_byExtName.end()) {
+            eraseLocked(it->second);
+        }
+    }
+
+    m_byId[entry.id] = {entry, Clock::now()};
+    m_byName[entry.name] = entry.id;
+    if (entry.extName) {
+        m_byExtName[*entry.extName] = entry.id;
+    }
+}
+
+// =====================================================================================================================
+
+void NameIndex::erase(uint32_t id)
+{
+    std::unique_lock lock(m_mutex);
+    ++m_generation;
+    eraseLocked(id);
+}
+
+void NameIndex::clear()
+{
+    std::unique_lock lock(m_mutex);
+    ++m_generation;
+    m_byId.clear();
+    m_byName.clear();
+    m_byExtName.clear();
+}
+
+void NameIndex::eraseLocked(uint32_t id)
+{
+    auto it = m_byId.find(id);
+    if (it == m_byId.end()) {
+        return;
+    }
+
+    const Entry& entry = it->second.entry;
+    if (auto nit = m_byName.find(entry.name); nit != m_byName.end() && nit->second == id) {
+        m_byName.erase(nit);
+    }
+    if (entry.extName) {
+        if (auto eit = m_byExtName.find(*entry.extName); eit != m_byExtName.end() && eit->second == id) {
+            m_byExtName.erase(eit);
+        }
+    }
+    m_byId.erase(it);
+}
+
+// =====================================================================================================================
+
+} // namespace fty::asset::db
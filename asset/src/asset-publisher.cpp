@@ -0,0 +1,234 @@
+#include "asset/asset-publisher.h"
+#include "asset/asset-configure-inform.h"
+#include "asset/logger.h"
+#include <fty_common_mlm_utils.h>
+#include <fty_proto.h>
+#include <malamute.h>
+
+namespace fty::asset {
+
+static constexpr auto CONNECT_RETRY   = std::chrono::seconds(1);
+static constexpr int  MAILBOX_TIMEOUT = 5000;
+
+// =====================================================================================================================
+
+Publisher::Queue::Queue()
+    : m_head(new Node)
+    , m_tail(m_head.load())
+{
+}
+
+Publisher::Queue::~Queue()
+{
+    Message msg;
+    while (pop(msg)) {
+        zmsg_destroy(&msg.msg);
+    }
+    delete m_tail;
+}
+
+void Publisher::Queue::push(Message&& msg)
+{
+    Node* node  = new Node;
+    node->value = std::move(msg);
+
+    Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+bool Publisher::Queue::pop(Message& msg)
+{
+    Node* next = m_tail->next.load(std::memory_order_acquire);
+    if (!next) {
+        return false;
+    }
+
+    msg = std::move(next->value);
+    delete m_tail;
+    m_tail = next;
+    return true;
+}
+
+bool Publisher::Queue::empty() const
+{
+    return m_tail->next.load(std::memory_order_acquire) == nullptr;
+}
+
+// =====================================================================================================================
+
+Publisher::Publisher()
+    : m_thread(&Publisher::run, this)
+{
+}
+
+Publisher::Publisher(Send send)
+    : m_send(std::move(send))
+    , m_thread(&Publisher::run, this)
+{
+}
+
+Publisher::~Publisher()
+{
+    stop();
+}
+
+Publisher& Publisher::instance()
+{
+    static Publisher publisher;
+    return publisher;
+}
+
+// =====================================================================================================================
+
+uint64_t Publisher::publish(const std::string& subject, zmsg_t** msg)
+{
+    return enqueue({}, subject, msg);
+}
+
+uint64_t Publisher::sendTo(const std::string& address, const std::string& subject, zmsg_t** msg)
+{
+    return enqueue(address, subject, msg);
+}
+
+uint64_t Publisher::enqueue(const std::string& address, const std::string& subject, zmsg_t** msg)
+{
+    if (m_stopped) {
+        zmsg_destroy(msg);
+        return 0;
+    }
+
+    Message message;
+    message.seq     = ++m_lastSeq;
+    message.address = address;
+    message.subject = subject;
+    message.msg     = *msg;
+    *msg            = nullptr;
+
+    uint64_t seq = message.seq;
+    m_queue.push(std::move(message));
+
+    // Empty critical section orders the push before the check of the waiting thread, so no wakeup is lost
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_wakeup.notify_one();
+    return seq;
+}
+
+// =====================================================================================================================
+
+bool Publisher::waitFor(uint64_t seq, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_acked.wait_for(lock, timeout, [&]() {
+        return m_ackedSeq >= seq;
+    });
+}
+
+bool Publisher::flush(std::chrono::milliseconds timeout)
+{
+    return waitFor(m_lastSeq, timeout);
+}
+
+void Publisher::acknowledge(uint64_t seq)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Producers can be preempted between taking a number and pushing, so sequence numbers may come out of order
+    m_sentAhead.insert(seq);
+    while (!m_sentAhead.empty() && *m_sentAhead.begin() == m_ackedSeq + 1) {
+        m_sentAhead.erase(m_sentAhead.begin());
+        ++m_ackedSeq;
+    }
+    m_acked.notify_all();
+}
+
+// =====================================================================================================================
+
+void Publisher::stop()
+{
+    if (m_stopped.exchange(true)) {
+        return;
+    }
+
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_wakeup.notify_one();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void Publisher::run()
+{
+    mlm_client_t*                         client = nullptr;
+    std::chrono::steady_clock::time_point lastConnect;
+
+    auto connect = [&]() {
+        lastConnect = std::chrono::steady_clock::now();
+
+        client = mlm_client_new();
+        if (!client) {
+            logError("mlm_client_new () failed.");
+            return;
+        }
+
+        std::string name = generateMlmClientId("web.asset_publisher");
+        if (mlm_client_connect(client, MLM_ENDPOINT, 1000, name.c_str()) == -1) {
+            logError("mlm_client_connect () failed.");
+            mlm_client_destroy(&client);
+            return;
+        }
+
+        if (mlm_client_set_producer(client, FTY_PROTO_STREAM_ASSETS) == -1) {
+            logError("mlm_client_set_producer () failed.");
+            mlm_client_destroy(&client);
+        }
+    };
+
+    while (true) {
+        bool stopping = m_stopped;
+
+        if (!m_send && !client && (stopping || std::chrono::steady_clock::now() - lastConnect >= CONNECT_RETRY)) {
+            connect();
+        }
+        bool connected = m_send || client;
+
+        // Send everything what is queued, messages wait in the queue while there is no connection
+        Message msg;
+        while ((connected || stopping) && m_queue.pop(msg)) {
+            bool sent = false;
+            if (m_send) {
+                sent = m_send(msg.address, msg.subject, &msg.msg);
+            } else if (!client) {
+                logError("Notification '{}' dropped, publisher is not connected", msg.subject);
+            } else if (msg.address.empty()) {
+                sent = mlm_client_send(client, msg.subject.c_str(), &msg.msg) == 0;
+            } else {
+                sent = mlm_client_sendto(
+                           client, msg.address.c_str(), msg.subject.c_str(), nullptr, MAILBOX_TIMEOUT, &msg.msg) == 0;
+            }
+
+            if (!sent) {
+                logError("Sending of notification '{}' failed", msg.subject);
+            }
+            zmsg_destroy(&msg.msg);
+            acknowledge(msg.seq);
+        }
+
+        if (stopping) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wakeup.wait_for(lock, CONNECT_RETRY, [&]() {
+            return m_stopped || (connected && !m_queue.empty());
+        });
+    }
+
+    if (client) {
+        zclock_sleep(500); // ensure that everything was send before we destroy the client
+        mlm_client_destroy(&client);
+    }
+}
+
+// =====================================================================================================================
+
+} // namespace fty::asset
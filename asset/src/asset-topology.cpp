@@ -0,0 +1,209 @@
+#include "asset/asset-topology.h"
+#include "asset/db.h"
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace fty::asset::db {
+
+static const std::string nodeSql = R"(
+    SELECT
+        id_asset_element, id_parent, id_type, id_subtype, name, status
+    FROM
+        t_bios_asset_element
+    WHERE
+        {} IN ({})
+)";
+
+// Upper bound of IN list placeholders in one statement, longer lists are split
+static constexpr size_t MAX_IN_LIST_SIZE = 1024;
+
+// Selects nodes whose column is one of the values, by chunks of IN lists
+template <typename Func>
+static void selectNodes(
+    tnt::Connection& conn, const std::string& column, const std::vector<uint32_t>& values, Func&& func)
+{
+    for (size_t offset = 0; offset < values.size(); offset += MAX_IN_LIST_SIZE) {
+        auto                  last = values.begin() + long(std::min(offset + MAX_IN_LIST_SIZE, values.size()));
+        std::vector<uint32_t> chunk(values.begin() + long(offset), last);
+
+        auto st = conn.prepare(fmt::format(nodeSql, column, tnt::inList("id", chunk.size())));
+        for (const auto& row : st.bindList("id", chunk).select()) {
+            Topology::Node node;
+            node.id        = row.get<uint32_t>("id_asset_element");
+            node.parentId  = row.get<uint32_t>("id_parent");
+            node.typeId    = row.get<uint16_t>("id_type");
+            node.subtypeId = row.get<uint16_t>("id_subtype");
+            node.name      = row.get("name");
+            node.status    = row.get("status");
+            func(std::move(node));
+        }
+    }
+}
+
+// =====================================================================================================================
+
+Topology::Topology(tnt::Connection& conn)
+    : m_conn(conn)
+{
+}
+
+// =====================================================================================================================
+
+std::optional<Topology::Node> Topology::node(uint32_t id)
+{
+    fetchNodes({id});
+
+    if (auto it = m_nodes.find(id); it != m_nodes.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+std::vector<Topology::Node> Topology::ancestors(uint32_t id)
+{
+    fetchAncestors({id});
+
+    std::vector<Node> ret;
+
+    auto it = m_nodes.find(id);
+    // Size limit protects against broken (cyclic) data
+    while (it != m_nodes.end() && it->second.parentId && ret.size() < m_nodes.size()) {
+        it = m_nodes.find(it->second.parentId);
+        if (it != m_nodes.end()) {
+            ret.push_back(it->second);
+        }
+    }
+    return ret;
+}
+
+void Topology::fetchAncestors(const std::vector<uint32_t>& ids)
+{
+    // One level of parents per query
+    std::vector<uint32_t>        level = ids;
+    std::unordered_set<uint32_t> visited(ids.begin(), ids.end());
+    while (!level.empty()) {
+        fetchNodes(level);
+
+        std::vector<uint32_t> parents;
+        for (uint32_t id : level) {
+            if (auto it = m_nodes.find(id); it != m_nodes.end() && it->second.parentId) {
+                if (visited.insert(it->second.parentId).second) {
+                    parents.push_back(it->second.parentId);
+                }
+            }
+        }
+        level = std::move(parents);
+    }
+}
+
+std::vector<Topology::Node> Topology::children(uint32_t containerId)
+{
+    fetchChildren({containerId});
+
+    std::vector<Node> ret;
+    for (uint32_t id : m_children[containerId]) {
+        ret.push_back(m_nodes.at(id));
+    }
+    return ret;
+}
+
+void Topology::fetchChildren(const std::vector<uint32_t>& containerIds)
+{
+    std::vector<uint32_t> missing;
+    for (uint32_t id : containerIds) {
+        if (!m_children.count(id)) {
+            missing.push_back(id);
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    for (uint32_t id : missing) {
+        m_children[id];
+    }
+
+    selectNodes(m_conn, "id_parent", missing, [&](Node&& node) {
+        m_children[node.parentId].push_back(node.id);
+        m_missing.erase(node.id);
+        m_nodes[node.id] = std::move(node);
+    });
+}
+
+std::vector<Topology::Node> Topology::descendants(uint32_t containerId, const Filter& filter)
+{
+    auto match = [&](const Node& node) {
+        if (!filter.types.empty() &&
+            std::find(filter.types.begin(), filter.types.end(), node.typeId) == filter.types.end()) {
+            return false;
+        }
+        if (!filter.subtypes.empty() &&
+            std::find(filter.subtypes.begin(), filter.subtypes.end(), node.subtypeId) == filter.subtypes.end()) {
+            return false;
+        }
+        return filter.status.empty() || filter.status == node.status;
+    };
+
+    std::vector<Node>            ret;
+    std::unordered_set<uint32_t> visited{containerId};
+    std::vector<uint32_t>        level{containerId};
+
+    // One level of the tree per query
+    while (!level.empty()) {
+        fetchChildren(level);
+
+        std::vector<uint32_t> next;
+        for (uint32_t parent : level) {
+            for (uint32_t id : m_children[parent]) {
+                if (!visited.insert(id).second) {
+                    continue;
+                }
+                next.push_back(id);
+                if (const auto& node = m_nodes.at(id); match(node)) {
+                    ret.push_back(node);
+                }
+            }
+        }
+        level = std::move(next);
+    }
+    return ret;
+}
+
+std::unordered_set<uint32_t> Topology::subtree(uint32_t containerId)
+{
+    std::unordered_set<uint32_t> ret{containerId};
+    for (const auto& node : descendants(containerId)) {
+        ret.insert(node.id);
+    }
+    return ret;
+}
+
+// =====================================================================================================================
+
+void Topology::fetchNodes(const std::vector<uint32_t>& ids)
+{
+    std::vector<uint32_t> missing;
+    for (uint32_t id : ids) {
+        if (!m_nodes.count(id) && !m_missing.count(id)) {
+            missing.push_back(id);
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    m_missing.insert(missing.begin(), missing.end());
+
+    selectNodes(m_conn, "id_asset_element", missing, [&](Node&& node) {
+        m_missing.erase(node.id);
+        m_nodes[node.id] = std::move(node);
+    });
+}
+
+// =====================================================================================================================
+
+} // namespace fty::asset::db
@@ -20,97 +20,345 @@
 
 #include "asset/csv.h"
 #include <algorithm>
-#include <cxxtools/csvdeserializer.h>
+#include <array>
+#include <cstring>
+#include <cxxtools/utf8codec.h>
 #include <fty_common.h>
 #include <fty_common_macros.h>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace fty::asset {
 
 /* Workaround for a fact a) std::transform to do a strip and lower is weird, b) it breaks the map somehow*/
-static const std::string _ci_strip(const std::string& str)
+static std::string _ci_strip(std::string_view str)
 {
-    std::ostringstream b;
+    std::string b;
+    b.reserve(str.size());
 
     for (const char c : str) {
         // allowed chars [a-zA-Z0-9_\.]
-        if (::isalnum(c) || c == '_' || c == '.')
-            b << static_cast<char>(::tolower(c));
+        if (::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.')
+            b.push_back(static_cast<char>(::tolower(static_cast<unsigned char>(c))));
     }
 
-    return b.str();
+    return b;
+}
+
+// Structural characters are searched 16 bytes at once where SSE2 is available (always on x86-64)
+
+// Position of the first of given characters, size if there is none
+static size_t findAny(const char* data, size_t pos, size_t size, char a, char b, char c)
+{
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i hits  = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb)), _mm_cmpeq_epi8(block, vc));
+        if (int mask = _mm_movemask_epi8(hits)) {
+            return pos + size_t(__builtin_ctz(unsigned(mask)));
+        }
+    }
+#endif
+    for (; pos < size; ++pos) {
+        if (data[pos] == a || data[pos] == b || data[pos] == c) {
+            return pos;
+        }
+    }
+    return size;
+}
+
+static bool isValidUtf8(std::string_view text)
+{
+    const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t      size = text.size();
+
+    for (size_t pos = 0; pos < size;) {
+#if defined(__SSE2__)
+        // ASCII only blocks
+        while (pos + 16 <= size &&
+               _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos))) == 0) {
+            pos += 16;
+        }
+        if (pos == size) {
+            break;
+        }
+#endif
+        unsigned char c = data[pos];
+        if (c < 0x80) {
+            ++pos;
+            continue;
+        }
+
+        size_t   len;
+        uint32_t cp;
+        uint32_t min;
+        if ((c & 0xe0) == 0xc0) {
+            len = 2, cp = c & 0x1f, min = 0x80;
+        } else if ((c & 0xf0) == 0xe0) {
+            len = 3, cp = c & 0x0f, min = 0x800;
+        } else if ((c & 0xf8) == 0xf0) {
+            len = 4, cp = c & 0x07, min = 0x10000;
+        } else {
+            return false;
+        }
+
+        if (pos + len > size) {
+            return false;
+        }
+        for (size_t i = 1; i < len; ++i) {
+            if ((data[pos + i] & 0xc0) != 0x80) {
+                return false;
+            }
+            cp = (cp << 6) | (data[pos + i] & 0x3f);
+        }
+        // overlong encodings, surrogates and values out of unicode range
+        if (cp < min || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) {
+            return false;
+        }
+        pos += len;
+    }
+    return true;
+}
+
+CsvMap::CsvMap(const CsvMap::Data& data)
+{
+    for (const auto& row : data) {
+        addRow();
+        for (const auto& value : row) {
+            addCell(value);
+        }
+    }
 }
 
 CsvMap::CsvMap(const CsvMap::CxxData& data)
-    : _data{}
-    , _title_to_index{}
 {
-    // XXX: this is ugly part, which takes the table of cxxtools::String and convert it to table of utf-8 encoded
-    // std::string
-    for (size_t i = 0; i != data.size(); i++) {
-        auto row = std::vector<std::string>{};
-        row.reserve(data[0].size());
+    for (const auto& row : data) {
+        addRow();
+        for (const auto& value : row) {
+            addCell(cxxtools::Utf8Codec::encode(value));
+        }
+    }
+}
+
+CsvMap CsvMap::parse(std::string&& text, char delimiter, char quote)
+{
+    if (text.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument(TRANSLATE_ME("CSV document is too big"));
+    }
+    if (!isValidUtf8(text)) {
+        throw std::invalid_argument(TRANSLATE_ME("CSV document is not valid UTF-8"));
+    }
+
+    // Cells are unquoted in place: the unquoted value is never longer than the source, so it is moved towards the
+    // beginning of the buffer and the table keeps offsets only
+    CsvMap map;
+    char*  data = text.data();
+    size_t size = text.size();
+    size_t pos  = 0;
+    size_t out  = 0;
+    size_t line = 1;
+
+    auto copy = [&](size_t from, size_t len) {
+        if (out != from) {
+            std::memmove(data + out, data + from, len);
+        }
+        out += len;
+    };
+
+    // UTF-8 byte order mark
+    if (text.compare(0, 3, "\xef\xbb\xbf") == 0) {
+        pos = 3;
+    }
+
+    bool inRow = false;
+    while (pos < size) {
+        if (!inRow) {
+            // empty lines are skipped
+            if (data[pos] == '\n' || data[pos] == '\r') {
+                line += data[pos] == '\n';
+                ++pos;
+                continue;
+            }
+            map.addRow();
+            inRow = true;
+        }
+
+        size_t start = out;
+        if (data[pos] == quote) {
+            size_t first = line;
+            ++pos;
+            while (true) {
+                size_t next = findAny(data, pos, size, quote, quote, quote);
+                if (next == size) {
+                    throw std::invalid_argument(TRANSLATE_ME("Quoted value on line %zu is not terminated", first));
+                }
+                line += size_t(std::count(data + pos, data + next, '\n'));
+                copy(pos, next - pos);
+                pos = next + 1;
+                // doubled quote is the quote itself
+                if (pos < size && data[pos] == quote) {
+                    data[out++] = quote;
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+        }
+
+        size_t end = findAny(data, pos, size, delimiter, '\n', '\r');
+        copy(pos, end - pos);
+        pos = end;
+        map.pushCell(start, out - start);
+
+        if (pos == size) {
+            break;
+        }
+        if (data[pos] == delimiter) {
+            if (++pos == size) {
+                map.pushCell(out, 0);
+            }
+            continue;
+        }
 
-        /*FIXME: segfaults!
-         * std::transform(data[i].begin(), data[i].end(), row.begin(),
-                [&](const cxxtools::String& s) -> std::string { return to_utf8(s); });
-        */
-        for (const auto& s : data[i]) {
-            row.push_back(cxxtools::Utf8Codec::encode(s));
+        if (data[pos] == '\r' && pos + 1 < size && data[pos + 1] == '\n') {
+            ++pos;
         }
-        _data.push_back(row);
+        ++pos;
+        ++line;
+        inRow = false;
     }
+
+    text.resize(out);
+    map._buffer = std::move(text);
+    return map;
+}
+
+void CsvMap::addRow()
+{
+    if (_rows.empty()) {
+        _rows.push_back(0);
+    }
+    _rows.push_back(_cells.size());
+}
+
+void CsvMap::addCell(std::string_view value)
+{
+    size_t offset = _buffer.size();
+    _buffer.append(value);
+    pushCell(offset, value.size());
+}
+
+void CsvMap::pushCell(size_t offset, size_t size)
+{
+    _cells.push_back({uint32_t(offset), uint32_t(size)});
+    _rows.back() = _cells.size();
+}
+
+size_t CsvMap::cellCount(size_t row_i) const
+{
+    return row_i < rows() ? _rows[row_i + 1] - _rows[row_i] : 0;
+}
+
+std::string_view CsvMap::cell(size_t row_i, size_t col_i) const
+{
+    const Cell& cell = _cells[_rows[row_i] + col_i];
+    return {_buffer.data() + cell.offset, cell.size};
 }
 
 void CsvMap::deserialize()
 {
 
-    if (_data.size() == 0) {
+    if (rows() == 0) {
         throw std::invalid_argument(TRANSLATE_ME("Can't process empty data set"));
     }
 
-    size_t i = 0;
-    for (const std::string& title_name : _data[0]) {
-        std::string title = _ci_strip(title_name);
+    for (size_t i = 0; i != cellCount(0); i++) {
+        std::string title = _ci_strip(cell(0, i));
         if (_title_to_index.count(title) == 1) {
             std::string msg = TRANSLATE_ME("duplicate title name '%s'", title.c_str());
             throw std::invalid_argument(msg);
         }
 
         _title_to_index.emplace(title, i);
-        i++;
+        _titles.insert(title);
     }
 }
 
-const std::string& CsvMap::get(size_t row_i, const std::string& title_name) const
+std::string CsvMap::get(size_t row_i, const std::string& title_name) const
+{
+    return std::string(view(row_i, title_name));
+}
+
+std::string_view CsvMap::view(size_t row_i, const std::string& title_name) const
 {
 
-    if (row_i >= _data.size()) {
-        std::string msg = TRANSLATE_ME("row_index %zu was out of range %zu", row_i, _data.size());
+    if (row_i >= rows()) {
+        std::string msg = TRANSLATE_ME("row_index %zu was out of range %zu", row_i, rows());
         throw std::out_of_range(msg);
     }
 
-    std::string title = _ci_strip(title_name);
+    return view(row_i, column(title_name));
+}
+
+CsvMap::Column CsvMap::column(const std::string& title_name) const
+{
+    if (auto col = findColumn(title_name)) {
+        return *col;
+    }
+
+    std::string msg = TRANSLATE_ME("title name '%s' not found", _ci_strip(title_name).c_str());
+    throw std::out_of_range{msg};
+}
 
-    if (_title_to_index.count(title) == 0) {
-        std::string msg = TRANSLATE_ME("title name '%s' not found", title.c_str());
-        throw std::out_of_range{msg};
+std::optional<CsvMap::Column> CsvMap::findColumn(const std::string& title_name) const
+{
+    if (auto it = _title_to_index.find(_ci_strip(title_name)); it != _title_to_index.end()) {
+        return Column{it->second};
     }
+    return std::nullopt;
+}
+
+std::string_view CsvMap::view(size_t row_i, Column col) const
+{
+    if (row_i >= rows()) {
+        std::string msg = TRANSLATE_ME("row_index %zu was out of range %zu", row_i, rows());
+        throw std::out_of_range(msg);
+    }
+
+    if (col.index >= cellCount(row_i)) {
+        std::string title = col.index < cellCount(0) ? std::string(cell(0, col.index)) : std::string();
 
-    size_t col_i = _title_to_index.at(title);
-    if (col_i >= _data[row_i].size()) {
         const char* err = "On line %zu: requested column %s (index %zu) where maximum is %zu";
-        throw std::out_of_range(TRANSLATE_ME(err, row_i + 1, title_name.c_str(), col_i + 1, _data[row_i].size()));
+        throw std::out_of_range(TRANSLATE_ME(err, row_i + 1, title.c_str(), col.index + 1, cellCount(row_i)));
     }
-    return _data[row_i][col_i];
+    return cell(row_i, col.index);
+}
+
+std::string CsvMap::get(size_t row_i, Column col) const
+{
+    return std::string(view(row_i, col));
+}
+
+std::string CsvMap::get_strip(size_t row_i, Column col) const
+{
+    return _ci_strip(view(row_i, col));
 }
 
 std::string CsvMap::get_strip(size_t row_i, const std::string& title_name) const
 {
-    return _ci_strip(get(row_i, title_name));
+    return _ci_strip(view(row_i, title_name));
 }
 
 bool CsvMap::hasTitle(const std::string& title_name) const
@@ -119,13 +367,9 @@ bool CsvMap::hasTitle(const std::string& title_name) const
     return (_title_to_index.count(title) == 1);
 }
 
-std::set<std::string> CsvMap::getTitles() const
+const std::set<std::string>& CsvMap::getTitles() const
 {
-    std::set<std::string> ret{};
-    for (auto i : _title_to_index) {
-        ret.emplace(i.first);
-    }
-    return ret;
+    return _titles;
 }
 
 std::string CsvMap::getCreateUser() const
@@ -178,49 +422,423 @@ void skip_utf8_BOM(std::istream& i)
     i.putback(char(c1));
 }
 
-char findDelimiter(std::istream& i, std::size_t max_pos)
+CsvDialect sniffDialect(std::string_view text, std::size_t max_records)
 {
-    for (std::size_t pos = 0; i.good() && !i.eof() && pos != max_pos; pos++) {
-        i.seekg(long(pos));
-        char ret = char(i.peek());
-        if (ret == ',' || ret == ';' || ret == '\t') {
-            i.seekg(0);
-            return ret;
+    static constexpr char delimiters[] = {',', ';', '\t'};
+
+    CsvDialect  dialect;
+    const auto* data   = reinterpret_cast<const unsigned char*>(text.data());
+    size_t      size   = text.size();
+    size_t      pos    = 0;
+    size_t      stride = 1;
+
+    if (size >= 3 && data[0] == 0xef && data[1] == 0xbb && data[2] == 0xbf) {
+        dialect.bom = true;
+        pos         = 3;
+    } else if (size >= 2 && data[0] == 0xff && data[1] == 0xfe) {
+        dialect.bom      = true;
+        dialect.encoding = CsvDialect::Encoding::Utf16LE;
+    } else if (size >= 2 && data[0] == 0xfe && data[1] == 0xff) {
+        dialect.bom      = true;
+        dialect.encoding = CsvDialect::Encoding::Utf16BE;
+    } else if (size >= 2 && data[0] != 0 && data[1] == 0) {
+        // titles are ASCII, in UTF-16 every other byte is zero
+        dialect.encoding = CsvDialect::Encoding::Utf16LE;
+    } else if (size >= 2 && data[0] == 0 && data[1] != 0) {
+        dialect.encoding = CsvDialect::Encoding::Utf16BE;
+    }
+
+    if (dialect.encoding != CsvDialect::Encoding::Utf8) {
+        stride = 2;
+        pos    = dialect.bom ? 2 : 0;
+    }
+
+    // Code unit at given position, only ASCII ones matter here
+    auto unit = [&](size_t at) -> uint32_t {
+        if (at + stride > size) {
+            return 0;
+        }
+        switch (dialect.encoding) {
+            case CsvDialect::Encoding::Utf16LE:
+                return uint32_t(data[at]) | uint32_t(data[at + 1]) << 8;
+            case CsvDialect::Encoding::Utf16BE:
+                return uint32_t(data[at]) << 8 | uint32_t(data[at + 1]);
+            default:
+                return data[at];
+        }
+    };
+
+    // Delimiters in every record, outside of quoted values
+    std::vector<std::array<size_t, 3>> counts(1);
+    size_t                             recordLength = 0;
+    size_t                             lf = 0, crlf = 0, cr = 0;
+    size_t                             quotedCells = 0, apostropheCells = 0;
+
+    bool     quoted     = false;
+    bool     cellStart  = true;
+    bool     apostrophe = false;
+    size_t   cellLength = 0;
+    uint32_t prev       = 0;
+
+    auto endCell = [&]() {
+        // value enclosed in apostrophes
+        if (apostrophe && cellLength > 1 && prev == '\'') {
+            ++apostropheCells;
+        }
+        cellStart  = true;
+        apostrophe = false;
+        cellLength = 0;
+    };
+
+    for (; pos + stride <= size && counts.size() <= max_records; pos += stride) {
+        uint32_t c = unit(pos);
+
+        if (quoted) {
+            if (c == '"') {
+                if (unit(pos + stride) == '"') {
+                    pos += stride;
+                } else {
+                    quoted = false;
+                }
+            }
+            prev = c;
+            continue;
+        }
+
+        if (c == '\r' || c == '\n') {
+            if (c == '\n') {
+                ++lf;
+            } else if (unit(pos + stride) == '\n') {
+                ++crlf;
+                pos += stride;
+            } else {
+                ++cr;
+            }
+
+            endCell();
+            // empty lines are skipped
+            if (recordLength > 0) {
+                counts.emplace_back();
+                recordLength = 0;
+            }
+            prev = c;
+            continue;
+        }
+
+        ++recordLength;
+        if (cellStart && c == '"') {
+            quoted    = true;
+            cellStart = false;
+            ++quotedCells;
+            prev = c;
+            continue;
+        }
+
+        auto delimiter = std::find(std::begin(delimiters), std::end(delimiters), char(c));
+        if (c < 0x80 && delimiter != std::end(delimiters)) {
+            ++counts.back()[size_t(delimiter - std::begin(delimiters))];
+            endCell();
+            prev = c;
+            continue;
+        }
+
+        if (cellStart) {
+            apostrophe = c == '\'';
+            cellStart  = false;
+        }
+        ++cellLength;
+        prev = c;
+    }
+    endCell();
+
+    if (recordLength == 0 && counts.size() > 1) {
+        counts.pop_back();
+    }
+
+    // Delimiter found the same number of times in the titles and in most of the records, then the most frequent one
+    size_t bestTitles = 0;
+    for (size_t i = 0; i < std::size(delimiters); ++i) {
+        size_t titles = counts[0][i];
+        if (titles == 0) {
+            continue;
+        }
+
+        size_t same = size_t(std::count_if(counts.begin(), counts.end(), [&](const auto& record) {
+            return record[i] == titles;
+        }));
+        double confidence = double(same) / double(counts.size());
+
+        if (confidence > dialect.confidence || (confidence == dialect.confidence && titles > bestTitles)) {
+            dialect.delimiter  = delimiters[i];
+            dialect.confidence = confidence;
+            bestTitles         = titles;
         }
     }
-    i.seekg(0);
-    return '\x0';
+
+    if (apostropheCells > 0 && quotedCells == 0) {
+        dialect.quote = '\'';
+    }
+
+    if (crlf >= lf && crlf >= cr && crlf > 0) {
+        dialect.lineEnding = CsvDialect::LineEnding::CrLf;
+    } else if (cr > lf) {
+        dialect.lineEnding = CsvDialect::LineEnding::Cr;
+    }
+
+    return dialect;
 }
 
-bool hasApostrof(std::istream& i)
+// Converts UTF-16 document (without byte order mark) to UTF-8
+static std::string utf16ToUtf8(std::string_view text, bool littleEndian)
 {
-    for (std::size_t pos = 0; i.good() && !i.eof(); pos++) {
-        i.seekg(long(pos));
-        char ret = char(i.peek());
-        if (ret == '\'') {
-            i.seekg(0);
-            return true;
+    if (text.size() % 2) {
+        throw std::invalid_argument(TRANSLATE_ME("CSV document is not valid UTF-16"));
+    }
+
+    const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+    auto        unit = [&](size_t at) -> uint32_t {
+        return littleEndian ? uint32_t(data[at]) | uint32_t(data[at + 1]) << 8
+                            : uint32_t(data[at]) << 8 | uint32_t(data[at + 1]);
+    };
+
+    std::string out;
+    out.reserve(text.size() / 2);
+    for (size_t pos = 0; pos < text.size(); pos += 2) {
+        uint32_t cp = unit(pos);
+        if (cp >= 0xd800 && cp <= 0xdbff) {
+            // surrogate pair
+            if (pos + 4 > text.size() || unit(pos + 2) < 0xdc00 || unit(pos + 2) > 0xdfff) {
+                throw std::invalid_argument(TRANSLATE_ME("CSV document is not valid UTF-16"));
+            }
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (unit(pos + 2) - 0xdc00);
+            pos += 2;
+        } else if (cp >= 0xdc00 && cp <= 0xdfff) {
+            throw std::invalid_argument(TRANSLATE_ME("CSV document is not valid UTF-16"));
+        }
+
+        if (cp < 0x80) {
+            out.push_back(char(cp));
+        } else if (cp < 0x800) {
+            out.push_back(char(0xc0 | (cp >> 6)));
+            out.push_back(char(0x80 | (cp & 0x3f)));
+        } else if (cp < 0x10000) {
+            out.push_back(char(0xe0 | (cp >> 12)));
+            out.push_back(char(0x80 | ((cp >> 6) & 0x3f)));
+            out.push_back(char(0x80 | (cp & 0x3f)));
+        } else {
+            out.push_back(char(0xf0 | (cp >> 18)));
+            out.push_back(char(0x80 | ((cp >> 12) & 0x3f)));
+            out.push_back(char(0x80 | ((cp >> 6) & 0x3f)));
+            out.push_back(char(0x80 | (cp & 0x3f)));
         }
     }
-    i.seekg(0);
-    return false;
+    return out;
 }
+
 CsvMap CsvMap_from_istream(std::istream& in)
 {
-    std::vector<std::vector<cxxtools::String>> data;
-    cxxtools::CsvDeserializer                  deserializer(in);
-    char                                       delimiter = findDelimiter(in);
-    if (delimiter == '\x0') {
+    return CsvMap_from_string(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+}
+
+// Checks and logs detected dialect
+static void useDialect(const CsvDialect& dialect)
+{
+    if (dialect.delimiter == '\x0') {
         std::string msg = TRANSLATE_ME("Cannot detect the delimiter, use comma (,) semicolon (;) or tabulator");
         log_error("%s\n", msg.c_str());
         LOG_END;
         throw std::invalid_argument(msg);
     }
-    log_debug("Using delimiter '%c'", delimiter);
-    deserializer.delimiter(delimiter);
-    deserializer.readTitle(false);
-    deserializer.deserialize(data);
-    CsvMap cm{data};
+    static const std::map<CsvDialect::LineEnding, const char*> lineEndings = {
+        {CsvDialect::LineEnding::Lf, "LF"}, {CsvDialect::LineEnding::CrLf, "CRLF"}, {CsvDialect::LineEnding::Cr, "CR"}};
+    log_debug("Using delimiter '%c' (confidence %.2f), quote %c, %s%s, %s line endings", dialect.delimiter,
+        dialect.confidence, dialect.quote, dialect.encoding == CsvDialect::Encoding::Utf8 ? "UTF-8" : "UTF-16",
+        dialect.bom ? " with BOM" : "", lineEndings.at(dialect.lineEnding));
+}
+
+CsvMap CsvMap_from_string(std::string text)
+{
+    auto dialect = sniffDialect(text);
+    useDialect(dialect);
+
+    if (dialect.encoding != CsvDialect::Encoding::Utf8) {
+        text = utf16ToUtf8(std::string_view(text).substr(dialect.bom ? 2 : 0),
+            dialect.encoding == CsvDialect::Encoding::Utf16LE);
+    }
+
+    CsvMap cm = CsvMap::parse(std::move(text), dialect.delimiter, dialect.quote);
+    cm.deserialize();
+    return cm;
+}
+
+// =====================================================================================================================
+
+// Size of the beginning of the document the dialect is detected from
+static constexpr size_t SniffSize = 64 * 1024;
+
+CsvReader::CsvReader(std::istream& in, size_t block_size)
+    : _in(in)
+    , _block_size(std::max<size_t>(block_size, 4))
+{
+}
+
+const CsvDialect& CsvReader::dialect() const
+{
+    return _dialect;
+}
+
+void CsvReader::start()
+{
+    _started = true;
+
+    // dialect is detected from the beginning of the document, byte order mark is not a part of the titles
+    std::string block = read(std::max(_block_size, SniffSize));
+    _dialect          = sniffDialect(block);
+    useDialect(_dialect);
+    append(std::string_view(block).substr(
+        _dialect.bom ? (_dialect.encoding == CsvDialect::Encoding::Utf8 ? 3 : 2) : 0));
+
+    size_t found = 0;
+    size_t end   = records(1, found);
+    while (found == 0 && fill()) {
+        end = records(1, found);
+    }
+    if (found == 0) {
+        throw std::invalid_argument(TRANSLATE_ME("Can't process empty data set"));
+    }
+
+    _titles.assign(_pending, 0, end);
+    _pending.erase(0, end);
+    if (_titles.back() != '\n' && _titles.back() != '\r') {
+        _titles.push_back('\n');
+    }
+}
+
+std::string CsvReader::read(size_t size)
+{
+    std::string block(size, '\0');
+    _in.read(block.data(), std::streamsize(block.size()));
+    block.resize(size_t(_in.gcount()));
+    _eof = !_in;
+    return block;
+}
+
+void CsvReader::append(std::string_view block)
+{
+    if (_dialect.encoding == CsvDialect::Encoding::Utf8) {
+        _pending.append(block);
+        return;
+    }
+
+    // UTF-16 is decoded up to the last complete character
+    _raw.append(block);
+    size_t len = _eof ? _raw.size() : _raw.size() & ~size_t(1);
+    if (!_eof && len >= 2) {
+        auto high = static_cast<unsigned char>(
+            _dialect.encoding == CsvDialect::Encoding::Utf16LE ? _raw[len - 1] : _raw[len - 2]);
+        if (high >= 0xd8 && high <= 0xdb) {
+            len -= 2;
+        }
+    }
+    _pending += utf16ToUtf8(std::string_view(_raw).substr(0, len), _dialect.encoding == CsvDialect::Encoding::Utf16LE);
+    _raw.erase(0, len);
+}
+
+// Reads next block of the stream, returns false at the end of the stream
+bool CsvReader::fill()
+{
+    if (_eof) {
+        return false;
+    }
+    append(read(_block_size));
+    return true;
+}
+
+// Returns the end of at most count complete records of the pending text, empty lines are not counted. The last record
+// is complete only at the end of the stream, when it is not terminated by a line end.
+size_t CsvReader::records(size_t count, size_t& found) const
+{
+    const char* data      = _pending.data();
+    size_t      size      = _pending.size();
+    char        delimiter = _dialect.delimiter;
+    char        quote     = _dialect.quote;
+    size_t      pos       = 0;
+    size_t      end       = 0;
+    bool        inRow     = false;
+
+    found = 0;
+    while (pos < size && found < count) {
+        if (!inRow) {
+            if (data[pos] == '\n' || data[pos] == '\r') {
+                end = ++pos;
+                continue;
+            }
+            inRow = true;
+        }
+
+        if (data[pos] == quote) {
+            ++pos;
+            while (true) {
+                size_t next = findAny(data, pos, size, quote, quote, quote);
+                if (next == size) {
+                    // not terminated yet, at the end of the stream the parser reports it
+                    pos = size;
+                    break;
+                }
+                pos = next + 1;
+                if (pos < size && data[pos] == quote) {
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+        }
+
+        pos = findAny(data, pos, size, delimiter, '\n', '\r');
+        if (pos == size) {
+            break;
+        }
+        if (data[pos] == delimiter) {
+            ++pos;
+            continue;
+        }
+
+        if (data[pos] == '\r' && pos + 1 < size && data[pos + 1] == '\n') {
+            ++pos;
+        }
+        end = ++pos;
+        ++found;
+        inRow = false;
+    }
+
+    if (inRow && pos >= size && _eof) {
+        end = size;
+        ++found;
+    }
+    return end;
+}
+
+std::optional<CsvMap> CsvReader::next(size_t rows)
+{
+    if (!_started) {
+        start();
+    }
+
+    size_t found = 0;
+    size_t end   = records(rows, found);
+    while (found < rows && fill()) {
+        end = records(rows, found);
+    }
+    if (found == 0) {
+        return std::nullopt;
+    }
+
+    std::string text;
+    text.reserve(_titles.size() + end);
+    text.append(_titles).append(_pending, 0, end);
+    _pending.erase(0, end);
+
+    CsvMap cm = CsvMap::parse(std::move(text), _dialect.delimiter, _dialect.quote);
     cm.deserialize();
     return cm;
 }
@@ -79,20 +79,37 @@ std::string getJsonAsset(uint32_t elemId)
         return json;
     }
 
+    // Resolve names of the asset and of everything it refers to at once
+    std::vector<uint32_t> ids = {tmp->id, tmp->parentId};
+    for (const auto& oneGroup : tmp->groups) {
+        ids.push_back(oneGroup.first);
+    }
+    for (const auto& oneLink : tmp->powers) {
+        ids.push_back(oneLink.srcId);
+    }
+    for (const auto& it : tmp->parents) {
+        ids.push_back(std::get<0>(it));
+    }
+
+    auto names = db::idToNameExtName(ids);
+    if (!names) {
+        log_error("Database failure: %s", names.error().c_str());
+        return json;
+    }
+
     std::string parent_name;
     std::string ext_parent_name;
-    auto parent_names = db::idToNameExtName(tmp->parentId);
-    if (parent_names) {
-        parent_name = parent_names->first;
-        ext_parent_name = parent_names->second;
+    if (auto parent = names->find(tmp->parentId); parent != names->end()) {
+        parent_name     = parent->second.first;
+        ext_parent_name = parent->second.second;
     }
 
-    std::pair<std::string, std::string> asset_names = DBAssets::id_to_name_ext_name(tmp->id);
-    if (asset_names.first.empty() && asset_names.second.empty()) {
+    auto asset_names = names->find(tmp->id);
+    if (asset_names == names->end()) {
         log_error("Database failure");
         return json;
     }
-    std::string asset_ext_name = asset_names.second;
+    std::string asset_ext_name = asset_names->second.second;
 
     json += "{";
 
@@ -121,13 +138,13 @@ std::string getJsonAsset(uint32_t elemId)
         uint32_t    i           = 1;
         std::string ext_name    = "";
         for (auto& oneGroup : tmp->groups) {
-            std::pair<std::string, std::string> group_names = DBAssets::id_to_name_ext_name(oneGroup.first);
-            if (group_names.first.empty() && group_names.second.empty()) {
+            auto group_names = names->find(oneGroup.first);
+            if (group_names == names->end()) {
                 log_error("Database failure");
                 json = "";
                 return json;
             }
-            ext_name = group_names.second;
+            ext_name = group_names->second.second;
             json += "{";
             json += utils::json::jsonify("id", oneGroup.second) + ",";
             json += utils::json::jsonify("name", ext_name);
@@ -149,14 +166,14 @@ std::string getJsonAsset(uint32_t elemId)
             size_t   power_count = tmp->powers.size();
             uint32_t i           = 1;
             for (auto& oneLink : tmp->powers) {
-                auto link_names = db::idToNameExtName(oneLink.srcId);
-                if (!link_names || (link_names->first.empty() && link_names->second.empty())) {
+                auto link_names = names->find(oneLink.srcId);
+                if (link_names == names->end()) {
                     log_error("Database failure");
                     json = "";
                     return json;
                 }
                 json += "{";
-                json += utils::json::jsonify("src_name", link_names->second) + ",";
+                json += utils::json::jsonify("src_name", link_names->second.second) + ",";
                 json += utils::json::jsonify("src_id", oneLink.srcName);
 
                 if (!oneLink.srcSocket.empty()) {
@@ -193,13 +210,13 @@ std::string getJsonAsset(uint32_t elemId)
 
         for (const auto& it : tmp->parents) {
             char                                comma    = i != tmp->parents.size() ? ',' : ' ';
-            std::pair<std::string, std::string> it_names = DBAssets::id_to_name_ext_name(std::get<0>(it));
-            if (it_names.first.empty() && it_names.second.empty()) {
+            auto it_names = names->find(std::get<0>(it));
+            if (it_names == names->end()) {
                 log_error("Database failure");
                 json = "";
                 return json;
             }
-            ext_name = it_names.second;
+            ext_name = it_names->second.second;
             json += "{";
             json += utils::json::jsonify("id", std::get<1>(it));
             json += "," + utils::json::jsonify("name", ext_name);
@@ -99,10 +99,7 @@ AssetExpected<uint32_t> AssetManager::createAsset(const std::string& json, const
 
         if (imported.at(1)) {
             if (sendNotify) {
-                // this code can be executed in multiple threads -> agent's name should
-                // be unique at the every moment
-                std::string agent_name = generateMlmClientId("web.asset_post");
-                if (auto sent = sendConfigure(*(imported.at(1)), import.operation(), agent_name); !sent) {
+                if (auto sent = sendConfigure(*(imported.at(1)), import.operation()); !sent) {
                     logError (sent.error());
                     return unexpected("Error during configuration sending of asset change notification. Consult system log."_tr);
                 }
@@ -1,5 +1,8 @@
 #include "asset/asset-db.h"
+#include "asset/asset-delete-plan.h"
 #include "asset/asset-manager.h"
+#include "asset/asset-names.h"
+#include "asset/asset-topology.h"
 #include "asset/db.h"
 #include "asset/logger.h"
 #include "asset/json.h"
@@ -14,66 +17,22 @@ static constexpr const char* AGENT_ASSET_ACTIVATOR               = "etn-licensin
 
 // =====================================================================================================================
 
-struct Element;
-using ElementPtr = std::shared_ptr<Element>;
-struct Element : public db::WebAssetElement
+static AssetExpected<void> setActive(uint32_t id, bool active)
 {
-    std::vector<ElementPtr> chidren;
-    std::vector<ElementPtr> links;
-    bool                    isDeleted = false;
-};
-
-// =====================================================================================================================
-
-// Collect children, filter by ids which should be deleted. If some ids will be in children, then we cannot delete asset
-static void collectChildren(
-    uint32_t parentId, std::vector<uint32_t>& children, const std::map<uint32_t, std::string>& ids)
-{
-    if (auto ret = db::selectAssetsByParent(parentId)) {
-        for (uint32_t id : *ret) {
-            if (ids.find(id) == ids.end()) {
-                children.push_back(id);
-            }
-            collectChildren(id, children, ids);
-        }
-    }
-}
-
-
-// Collect links, filter by ids which should be deleted. If some ids will be in links, then we cannot delete asset
-static void collectLinks(uint32_t elementId, std::vector<uint32_t>& links, const std::map<uint32_t, std::string>& ids)
-{
-    if (auto ret = db::selectAssetDeviceLinksSrc(elementId)) {
-        for (uint32_t id : *ret) {
-            if (ids.find(id) == ids.end()) {
-                links.push_back(id);
-            }
+    try {
+        std::string         assetJson = getJsonAsset(id);
+        mlm::MlmSyncClient  client(AGENT_FTY_ASSET, AGENT_ASSET_ACTIVATOR);
+        fty::AssetActivator activationAccessor(client);
+        if (active) {
+            activationAccessor.activate(assetJson);
+        } else {
+            activationAccessor.deactivate(assetJson);
         }
-    }
-}
-
-// Delete asset recursively
-static AssetExpected<void> deleteAssetRec(ElementPtr& el)
-{
-    if (el->isDeleted) {
         return {};
+    } catch (const std::exception& e) {
+        logError("Error during asset {} - {}", active ? "activation" : "deactivation", e.what());
+        return unexpected(e.what());
     }
-
-    for (auto& it : el->links) {
-        if (auto ret = deleteAssetRec(it); !ret) {
-            return unexpected(ret.error());
-        }
-    }
-    for (auto& it : el->chidren) {
-        if (auto ret = deleteAssetRec(it); !ret) {
-            return unexpected(ret.error());
-        }
-    }
-    if (auto ret = AssetManager::deleteAsset(*el); !ret) {
-        return unexpected(ret.error());
-    }
-    el->isDeleted = true;
-    return {};
 }
 
 // =====================================================================================================================
@@ -150,64 +109,206 @@ AssetExpected<db::AssetElement> AssetManager::deleteAsset(const db::AssetElement
     return ret ? AssetExpected<db::AssetElement>(*ret) : unexpected(ret.error());
 }
 
-std::map<std::string, AssetExpected<db::AssetElement>> AssetManager::deleteAsset(const std::map<uint32_t, std::string>& ids)
+// Collects candidates and their dependencies, with a constant number of queries, the tree comes from topology
+static AssetExpected<void> prepareDelete(tnt::Connection& conn, const std::map<uint32_t, std::string>& ids,
+    std::map<uint32_t, db::WebAssetElement>& elements, DeletePlan& plan)
 {
-    std::map<std::string, AssetExpected<db::AssetElement>> result;
-    std::vector<std::shared_ptr<Element>>             toDel;
+    static const Translate linkedError =
+        "can't delete the asset because it has at least one child or asset is linked"_tr;
+    static const Translate logicalError = "a logical_asset (sensor) refers to it"_tr;
 
+    std::vector<uint32_t> idList;
     for (const auto& [id, name] : ids) {
-        ElementPtr el = std::make_shared<Element>();
+        idList.push_back(id);
+    }
+
+    try {
+        if (auto ret = db::selectAssetElementsWebByIds(conn, idList)) {
+            for (auto& el : *ret) {
+                plan.addCandidate(el.id);
+                elements.emplace(el.id, std::move(el));
+            }
+        } else {
+            return unexpected(ret.error());
+        }
 
-        if (auto ret = db::selectAssetElementWebById(id, *el)) {
-            std::vector<uint32_t> allChildren;
-            collectChildren(el->id, allChildren, ids);
+        // Children which are not deleted block the parent
+        db::Topology topology(conn);
+        topology.fetchChildren(idList);
 
-            std::vector<uint32_t> links;
-            collectLinks(el->id, links, ids);
+        std::vector<std::string>                  names;
+        std::unordered_map<std::string, uint32_t> idByName;
+        for (const auto& [id, el] : elements) {
+            names.push_back(el.name);
+            idByName.emplace(el.name, id);
 
-            if (!allChildren.empty() || !links.empty()) {
-                result.emplace(
-                    name, unexpected("can't delete the asset because it has at least one child or asset is linked"_tr));
-            } else {
-                toDel.push_back(el);
+            if (el.name == "rackcontroller-0") {
+                logDebug("Prevented deleting RC-0");
+                plan.fail(id, "Prevented deleting RC-0");
+            }
+
+            for (const auto& child : topology.children(id)) {
+                plan.require(id, child.id, linkedError);
             }
-        } else {
-            result.emplace(name, unexpected(ret.error()));
         }
-    }
 
-    auto find = [&](uint32_t id) {
-        auto ret = std::find_if(toDel.begin(), toDel.end(), [&](const auto& ptr) {
-            return ptr->id == id;
-        });
-        return ret != toDel.end() ? *ret : nullptr;
-    };
-
-    for (auto& it : toDel) {
-        // Collect element children
-        if (auto ret = db::selectAssetsByParent(it->id)) {
-            for (uint32_t id : *ret) {
-                if (auto el = find(id)) {
-                    it->chidren.push_back(el);
+        // Same for powered devices
+        if (auto links = db::selectAssetDeviceLinksSrc(conn, idList)) {
+            for (const auto& [src, dests] : *links) {
+                for (uint32_t dest : dests) {
+                    plan.require(src, dest, linkedError);
                 }
             }
+        } else {
+            return unexpected(links.error());
         }
-        // Collect element links
-        if (auto ret = db::selectAssetDeviceLinksSrc(it->id)) {
-            for (uint32_t id : *ret) {
-                if (auto el = find(id)) {
-                    it->links.push_back(el);
+
+        // And for sensors which refer to the asset as their logical asset
+        if (auto owners = db::selectKeytagOwners(conn, "logical_asset", names)) {
+            for (const auto& [name, ownerIds] : *owners) {
+                if (auto it = idByName.find(name); it != idByName.end()) {
+                    for (uint32_t owner : ownerIds) {
+                        plan.require(it->second, owner, logicalError);
+                    }
                 }
             }
+        } else {
+            return unexpected(owners.error());
+        }
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+
+    plan.build();
+
+    // Don't allow the deletion of the last datacenter (unless overriden)
+    if (getenv(ENV_OVERRIDE_LAST_DC_DELETION_CHECK) == nullptr) {
+        std::vector<uint32_t> datacenters;
+        for (const auto& [id, el] : elements) {
+            if (el.typeId == persist::asset_type::DATACENTER && plan.isDeletable(id)) {
+                datacenters.push_back(id);
+            }
+        }
+
+        if (!datacenters.empty()) {
+            auto count = db::countAssetsByType(conn, persist::asset_type::DATACENTER);
+            if (!count) {
+                return unexpected(count.error());
+            }
+            if (datacenters.size() >= *count) {
+                plan.fail(datacenters.back(), "will not allow last datacenter to be deleted"_tr);
+                plan.build();
+            }
+        }
+    }
+
+    return {};
+}
+
+// Removes relations of all planned assets, then the assets layer by layer, in one transaction
+static Expected<void> executeDelete(const DeletePlan& plan)
+{
+    std::vector<uint32_t> all;
+    for (const auto& layer : plan.layers()) {
+        all.insert(all.end(), layer.begin(), layer.end());
+    }
+
+    if (all.empty()) {
+        return {};
+    }
+
+    try {
+        tnt::Connection  conn;
+        tnt::Transaction trans(conn);
+        if (auto res = db::deleteAssetGroupRelations(conn, all); !res) {
+            return unexpected(res.error());
+        }
+        if (auto res = db::deleteAssetLinks(conn, all); !res) {
+            return unexpected(res.error());
+        }
+        if (auto res = db::deleteMonitorAssetRelations(conn, all); !res) {
+            return unexpected(res.error());
+        }
+        for (const auto& layer : plan.layers()) {
+            if (auto res = db::deleteAssetElements(conn, layer); !res) {
+                return unexpected(res.error());
+            }
+        }
+        trans.commit();
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+
+    for (uint32_t id : all) {
+        db::NameIndex::instance().erase(id);
+    }
+    return {};
+}
+
+std::map<std::string, AssetExpected<db::AssetElement>> AssetManager::deleteAsset(const std::map<uint32_t, std::string>& ids)
+{
+    std::map<std::string, AssetExpected<db::AssetElement>> result;
+    std::map<uint32_t, db::WebAssetElement>                elements;
+    DeletePlan                                             plan;
+
+    AssetExpected<void> prepared;
+    try {
+        tnt::Connection conn;
+        prepared = prepareDelete(conn, ids, elements, plan);
+    } catch (const std::exception& e) {
+        prepared = unexpected(e.what());
+    }
+
+    if (!prepared) {
+        logError(prepared.error().toString());
+        for (const auto& [id, name] : ids) {
+            result.emplace(name, unexpected(prepared.error()));
+        }
+        return result;
+    }
+
+    for (const auto& [id, name] : ids) {
+        if (!plan.isCandidate(id)) {
+            result.emplace(name, unexpected(error(Errors::ElementNotFound).format(name)));
+        }
+    }
+
+    // make the devices inactive first
+    std::vector<uint32_t> deactivated;
+    for (const auto& [id, el] : elements) {
+        if (!plan.isDeletable(id) || el.status != "active") {
+            continue;
+        }
+        if (auto ret = setActive(id, false)) {
+            deactivated.push_back(id);
+        } else {
+            plan.fail(id, ret.error());
+        }
+    }
+    plan.build();
+
+    if (auto ret = executeDelete(plan); !ret) {
+        logError(ret.error());
+        for (const auto& layer : plan.layers()) {
+            for (uint32_t id : layer) {
+                plan.fail(id, "error occured during removing element"_tr);
+            }
+        }
+        plan.build();
+    }
+
+    // in case of error we need to try to activate the assets again
+    for (uint32_t id : deactivated) {
+        if (!plan.isDeletable(id)) {
+            setActive(id, true);
         }
     }
 
-    // Delete all elements recursively
-    for (auto& it : toDel) {
-        if (auto ret = deleteAssetRec(it)) {
-            result.emplace(it->name, *it);
+    for (const auto& [id, el] : elements) {
+        if (auto reason = plan.failure(id)) {
+            result.emplace(ids.at(id), unexpected(*reason));
         } else {
-            result.emplace(it->name, unexpected(ret.error()));
+            result.emplace(el.name, el);
         }
     }
 
@@ -267,6 +368,7 @@ AssetExpected<db::AssetElement> AssetManager::deleteDcRoomRowRack(const db::Asse
     }
 
     trans.commit();
+    db::NameIndex::instance().erase(element.id);
     return element;
 }
 
@@ -288,6 +390,7 @@ AssetExpected<db::AssetElement> AssetManager::deleteGroup(const db::AssetElement
     }
 
     trans.commit();
+    db::NameIndex::instance().erase(element.id);
     return element;
 }
 
@@ -321,6 +424,7 @@ AssetExpected<db::AssetElement> AssetManager::deleteDevice(const db::AssetElemen
     }
 
     trans.commit();
+    db::NameIndex::instance().erase(element.id);
     return element;
 }
 
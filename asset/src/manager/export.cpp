@@ -1,12 +1,16 @@
 #include "asset/asset-manager.h"
+#include "asset/asset-topology.h"
+#include "asset/db.h"
 #include <cxxtools/csvserializer.h>
 #include <fty/split.h>
+#include <algorithm>
 
 namespace fty::asset {
 
-static AssetExpected<void> updateKeytags(const std::vector<std::string>& aek, std::vector<std::string>& s)
+static AssetExpected<void> updateKeytags(
+    tnt::Connection& conn, const std::vector<std::string>& aek, std::vector<std::string>& s)
 {
-    if (auto ret = db::selectExtRwAttributesKeytags()) {
+    if (auto ret = db::selectExtRwAttributesKeytags(conn)) {
         for (const auto& tag : *ret) {
             if (std::find(aek.cbegin(), aek.cend(), tag) != aek.end()) {
                 return {};
@@ -58,11 +62,154 @@ protected:
     std::vector<std::string> _buf;
 };
 
+// Number of elements read and written at once, memory of the export is bounded by it and not by number of assets
+static constexpr size_t EXPORT_PAGE_SIZE = 1024;
+
+// Page of exported elements and the data joined to them, selected in a fixed number of queries. Every page is read
+// on a short connection and written before the next one is read, so neither the connection nor the data of all
+// assets are held while the client reads the reply
+struct ExportPage
+{
+    std::vector<db::WebAssetElement>                        elements;
+    std::map<uint32_t, db::Attributes>                      extAttributes;
+    std::map<uint32_t, std::vector<db::DbAssetLink>>        powerLinks;
+    std::map<uint32_t, std::vector<uint32_t>>               groups;
+    std::map<uint32_t, std::pair<std::string, std::string>> names;    //!< locations, power sources and groups
+    std::map<std::string, std::string>                      extNames; //!< logical assets
+};
+
+static bool isInside(db::Topology& topology, uint32_t dc, uint32_t id)
+{
+    if (id == dc) {
+        return true;
+    }
+    for (const auto& node : topology.ancestors(id)) {
+        if (node.id == dc) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads elements which follow given id, returns false when there is nothing more to read. Elements outside of
+// datacenter are skipped, so the page can be empty even if there are more of them.
+static AssetExpected<bool> readPage(const std::optional<uint32_t>& dc, uint32_t& afterId, ExportPage& page)
+{
+    page = {};
+
+    try {
+        tnt::Connection conn;
+
+        if (auto ret = db::selectAssetElementPage(conn, afterId, EXPORT_PAGE_SIZE)) {
+            page.elements = std::move(*ret);
+        } else {
+            return unexpected(ret.error());
+        }
+
+        if (page.elements.empty()) {
+            return false;
+        }
+        afterId = page.elements.back().id;
+
+        if (dc) {
+            std::vector<uint32_t> all;
+            all.reserve(page.elements.size());
+            for (const auto& el : page.elements) {
+                all.push_back(el.id);
+            }
+
+            db::Topology topology(conn);
+            topology.fetchAncestors(all);
+            page.elements.erase(std::remove_if(page.elements.begin(), page.elements.end(),
+                                    [&](const db::WebAssetElement& el) {
+                                        return !isInside(topology, *dc, el.id);
+                                    }),
+                page.elements.end());
+        }
+
+        if (page.elements.empty()) {
+            return true;
+        }
+
+        std::vector<uint32_t> ids;
+        ids.reserve(page.elements.size());
+        for (const auto& el : page.elements) {
+            ids.push_back(el.id);
+        }
+
+        if (auto ret = db::selectExtAttributesByIds(conn, ids)) {
+            page.extAttributes = std::move(*ret);
+        } else {
+            return unexpected(ret.error());
+        }
+
+        if (auto ret = db::selectAssetDeviceLinksToByIds(conn, ids, INPUT_POWER_CHAIN)) {
+            page.powerLinks = std::move(*ret);
+        } else {
+            return unexpected(ret.error());
+        }
+
+        if (auto ret = db::selectAssetGroupsByIds(conn, ids)) {
+            page.groups = std::move(*ret);
+        } else {
+            return unexpected(ret.error());
+        }
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
+    }
+
+    // Locations, power sources and groups can be outside of datacenter and of the page, they are resolved by name
+    // conversions, which use own connection
+    std::vector<uint32_t> nameIds;
+    for (const auto& el : page.elements) {
+        if (el.parentId) {
+            nameIds.push_back(el.parentId);
+        }
+    }
+    for (const auto& [id, links] : page.powerLinks) {
+        for (const auto& link : links) {
+            nameIds.push_back(link.srcId);
+        }
+    }
+    for (const auto& [id, groups] : page.groups) {
+        nameIds.insert(nameIds.end(), groups.begin(), groups.end());
+    }
+
+    if (auto ret = db::idToNameExtName(nameIds)) {
+        page.names = std::move(*ret);
+    } else {
+        return unexpected(ret.error());
+    }
+
+    std::vector<std::string> logical;
+    for (const auto& [id, attrs] : page.extAttributes) {
+        if (auto it = attrs.find("logical_asset"); it != attrs.end()) {
+            logical.push_back(it->second.value);
+        }
+    }
+
+    if (!logical.empty()) {
+        if (auto ret = db::nameToExtName(logical)) {
+            page.extNames = std::move(*ret);
+        } else {
+            return unexpected(ret.error());
+        }
+    }
+
+    return true;
+}
+
 AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::AssetElement>& dc)
 {
     std::stringstream ss;
-    LineCsvSerializer lcs(ss);
+    if (auto ret = exportCsv(ss, dc); !ret) {
+        return unexpected(ret.error());
+    }
+    return ss.str();
+}
 
+AssetExpected<void> AssetManager::exportCsv(std::ostream& out, const std::optional<db::AssetElement>& dc)
+{
     // TODO: move somewhere else
     std::vector<std::string> KEYTAGS = {"description", "ip.1", "company", "site_name", "region", "country", "address",
         "contact_name", "contact_email", "contact_phone", "u_size", "manufacturer", "model", "serial_no", "runtime",
@@ -73,24 +220,33 @@ AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::Asset
         "id", "name", "type", "sub_type", "location", "status", "priority", "asset_tag"};
 
     uint32_t max_power_links = 1;
-    if (auto ret = db::maxNumberOfPowerLinks()) {
-        max_power_links = *ret;
-    } else {
-        return unexpected(ret.error());
-    }
+    uint32_t max_groups      = 1;
 
-    uint32_t max_groups = 1;
-    if (auto ret = db::maxNumberOfAssetGroups()) {
-        max_groups = *ret;
-    } else {
-        return unexpected(ret.error());
-    }
+    try {
+        tnt::Connection conn;
+
+        if (auto ret = db::maxNumberOfPowerLinks(conn)) {
+            max_power_links = *ret;
+        } else {
+            return unexpected(ret.error());
+        }
 
-    // put all remaining keys from the database
-    if (auto rv = updateKeytags(ASSET_ELEMENT_KEYTAGS, KEYTAGS); !rv) {
-        return unexpected(rv.error());
+        if (auto ret = db::maxNumberOfAssetGroups(conn)) {
+            max_groups = *ret;
+        } else {
+            return unexpected(ret.error());
+        }
+
+        // put all remaining keys from the database
+        if (auto rv = updateKeytags(conn, ASSET_ELEMENT_KEYTAGS, KEYTAGS); !rv) {
+            return unexpected(rv.error());
+        }
+    } catch (const std::exception& e) {
+        return unexpected(e.what());
     }
 
+    LineCsvSerializer lcs(out);
+
     // 1 print the first row with names
     // 1.1      names from asset element table itself
     for (const auto& k : ASSET_ELEMENT_KEYTAGS) {
@@ -122,23 +278,35 @@ AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::Asset
     lcs.add("id");
     lcs.serialize();
 
-    auto res = db::selectAssetElementAll(dc ? std::optional(dc->id) : std::nullopt);
-    if (!res) {
-        return unexpected(res.error());
-    }
+    static const std::vector<db::DbAssetLink> noLinks;
+    static const std::vector<uint32_t>        noGroups;
 
-    for (const db::WebAssetElement& el : *res) {
-        std::string location;
-        if (auto ret = db::idToNameExtName(el.parentId)) {
-            location = ret->second;
+    ExportPage page;
+
+    auto extName = [&](const std::string& name) -> AssetExpected<std::string> {
+        if (auto it = page.extNames.find(name); it != page.extNames.end()) {
+            return it->second;
+        }
+        return unexpected(error(Errors::ElementNotFound).format(name));
+    };
+
+    auto extNameById = [&](uint32_t id) -> AssetExpected<std::string> {
+        if (auto it = page.names.find(id); it != page.names.end()) {
+            return it->second.second;
         }
+        return unexpected(error(Errors::ElementNotFound).format(id));
+    };
 
-        auto extAttrsRet = db::selectExtAttributes(el.id);
-        if (!extAttrsRet) {
-            return unexpected(extAttrsRet.error());
+    auto writeRow = [&](const db::WebAssetElement& el) -> AssetExpected<void> {
+        std::string location;
+        if (auto ret = extNameById(el.parentId)) {
+            location = *ret;
         }
 
-        auto ext_attrs = std::move(*extAttrsRet);
+        db::Attributes ext_attrs;
+        if (auto it = page.extAttributes.find(el.id); it != page.extAttributes.end()) {
+            ext_attrs = std::move(it->second);
+        }
 
         // 2.5      PRINT IT
         // 2.5.1    things from asset element table itself
@@ -165,26 +333,24 @@ AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::Asset
         lcs.add(el.assetTag);
 
         // 2.5.2        power location
-        auto power_links = db::selectAssetDeviceLinksTo(el.id, INPUT_POWER_CHAIN);
-        if (!power_links) {
-            return unexpected(power_links.error());
-        }
+        auto        powerLinksIt = page.powerLinks.find(el.id);
+        const auto& power_links  = powerLinksIt != page.powerLinks.end() ? powerLinksIt->second : noLinks;
 
         for (uint32_t i = 0; i != max_power_links; ++i) {
             std::string source;
             std::string plug_src;
             std::string input;
 
-            if (i >= power_links->size()) {
+            if (i >= power_links.size()) {
                 // nothing here, exists only for consistency reasons
             } else {
-                auto rv = db::nameToExtName(power_links->at(i).destSocket);
+                auto rv = extNameById(power_links[i].srcId);
                 if (!rv) {
                     return unexpected(rv.error());
                 }
                 source   = *rv;
-                plug_src = power_links->at(i).srcSocket;
-                input    = std::to_string(power_links->at(i).destId);
+                plug_src = power_links[i].srcSocket;
+                input    = power_links[i].destSocket;
             }
             lcs.add(source);
             lcs.add(plug_src);
@@ -195,7 +361,7 @@ AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::Asset
         {
             auto it = ext_attrs.find("logical_asset");
             if (it != ext_attrs.end()) {
-                auto extname = db::nameToExtName(it->second.value);
+                auto extname = extName(it->second.value);
                 if (!extname) {
                     return unexpected(extname.error());
                 }
@@ -213,16 +379,14 @@ AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::Asset
         }
 
         // 2.5.4        groups
-        auto groupNames = db::selectGroupNames(el.id);
-        if (!groupNames) {
-            return unexpected(groupNames.error());
-        }
+        auto        groupsIt = page.groups.find(el.id);
+        const auto& groups   = groupsIt != page.groups.end() ? groupsIt->second : noGroups;
 
         for (uint32_t i = 0; i != max_groups; i++) {
-            if (i >= groupNames->size()) {
+            if (i >= groups.size()) {
                 lcs.add("");
             } else {
-                auto extname = db::nameToExtName(groupNames->at(i));
+                auto extname = extNameById(groups[i]);
                 if (!extname) {
                     return unexpected(extname.error());
                 }
@@ -232,9 +396,34 @@ AssetExpected<std::string> AssetManager::exportCsv(const std::optional<db::Asset
 
         lcs.add(el.name);
         lcs.serialize();
+        return {};
+    };
+
+    // 2 write elements, one row each, page by page
+    std::optional<uint32_t> dcId   = dc ? std::optional(dc->id) : std::nullopt;
+    uint32_t                lastId = 0;
+    while (true) {
+        auto read = readPage(dcId, lastId, page);
+        if (!read) {
+            return unexpected(read.error());
+        }
+        if (!*read) {
+            break;
+        }
+
+        for (const auto& el : page.elements) {
+            if (auto written = writeRow(el); !written) {
+                return written;
+            }
+        }
+
+        // Nothing more is read once the output is broken (client is gone)
+        if (!out) {
+            return unexpected("Export output failed"_tr);
+        }
     }
 
-    return ss.str();
+    return {};
 }
 
 }
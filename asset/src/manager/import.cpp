@@ -1,37 +1,39 @@
-#include "asset/asset-import.h"
+#include "asset/asset-import-jobs.h"
 #include "asset/asset-manager.h"
-#include "asset/csv.h"
-#include "asset/logger.h"
-
-#define CREATE_MODE_CSV 2
 
 namespace fty::asset {
 
+// Imports all the parts of the document, failure after some rows were processed is reported with their results
+static AssetExpected<AssetManager::ImportList> importAll(CsvImport& import)
+{
+    while (import.next()) {
+    }
+    if (!import.status() && import.items().empty()) {
+        return unexpected(import.status().error());
+    }
+    return import.items();
+}
+
 AssetExpected<AssetManager::ImportList> AssetManager::importCsv(
     const std::string& csvStr, const std::string& user, bool sendNotify)
 {
-    std::stringstream ss(csvStr);
-    CsvMap            csv = CsvMap_from_istream(ss);
+    CsvImport import(std::string_view(csvStr), user, sendNotify);
+    return importAll(import);
+}
 
-    csv.setCreateMode(CREATE_MODE_CSV);
-    csv.setCreateUser(user);
-    csv.setUpdateUser(user);
+AssetExpected<AssetManager::ImportList> AssetManager::validateCsv(
+    const std::string& csvStr, const std::string& user, bool sendNotify)
+{
+    CsvImport import(std::string_view(csvStr), user, sendNotify);
+    import.setDryRun(true);
+    return importAll(import);
+}
 
-    Import import(csv);
-    if (auto ret = import.process(sendNotify)) {
-        AssetManager::ImportList res;
-        const auto& list = import.items();
-        for(const auto&[row, el]: list) {
-            if (el) {
-                res.emplace(row, el->id);
-            } else {
-                res.emplace(row, unexpected(el.error()));
-            }
-        }
-        return res;
-    } else {
-        return unexpected(ret.error());
-    }
+AssetExpected<AssetManager::ImportList> AssetManager::importCsv(
+    std::istream& in, const std::string& user, bool sendNotify)
+{
+    CsvImport import(in, user, sendNotify);
+    return importAll(import);
 }
 
 } // namespace fty::asset
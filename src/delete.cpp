@@ -54,8 +54,7 @@ unsigned Delete::deleteOneAsset(const std::string& idStr)
         throw rest::errors::DataConflict(idStr, reason);
     }
 
-    std::string agent_name = generateMlmClientId("web.asset_delete");
-    if (auto ret = sendConfigure(*res, persist::asset_operation::DELETE, agent_name)) {
+    if (auto ret = sendConfigure(*res, persist::asset_operation::DELETE)) {
         m_reply << "{}";
         auditInfo("Request DELETE asset id {} SUCCESS", idStr);
         return HTTP_OK;
@@ -112,14 +111,13 @@ unsigned Delete::deleteAssets(const std::string& idsStr)
     }
 
     pack::ObjectList<Ret> ret;
-    std::string           agent_name = generateMlmClientId("web.asset_delete");
 
     for (const auto& [name, asset] : result) {
         auto& retVal  = ret.append();
         retVal.status = asset ? "OK" : "ERROR";
         retVal.asset  = name;
         if (asset) {
-            sendConfigure(*asset, persist::asset_operation::DELETE, agent_name);
+            sendConfigure(*asset, persist::asset_operation::DELETE);
         } else {
             rest::json(asset.error(), retVal.reason);
         }
@@ -118,10 +118,7 @@ unsigned Edit::run()
         }
 
         if (imported.at(1)) {
-            // this code can be executed in multiple threads -> agent's name should
-            // be unique at the every moment
-            std::string agent_name = generateMlmClientId("web.asset_put");
-            if (auto sent = sendConfigure(*(imported.at(1)), import.operation(), agent_name); !sent) {
+            if (auto sent = sendConfigure(*(imported.at(1)), import.operation()); !sent) {
                 logError(sent.error());
                 throw rest::errors::Internal(sent.error());
             }
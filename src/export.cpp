@@ -1,13 +1,66 @@
 #include "export.h"
 #include "asset/asset-db.h"
 #include "asset/asset-manager.h"
+#include "asset/logger.h"
 #include <chrono>
 #include <fty/rest/component.h>
 #include <fty_common_asset_types.h>
 #include <regex>
+#include <stdexcept>
+#include <streambuf>
 
 namespace fty::asset {
 
+// Forwards export to the reply by chunks of bounded size. Reply is switched to direct mode when the first chunk is
+// full, so memory used doesn't depend on export size. Small exports are sent as a regular reply.
+class ReplyBuffer : public std::streambuf
+{
+public:
+    explicit ReplyBuffer(tnt::HttpReply& reply, size_t size = 64 * 1024)
+        : m_reply(reply)
+        , m_buffer(size)
+    {
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    }
+
+    bool isStarted() const
+    {
+        return m_started;
+    }
+
+    void finish()
+    {
+        m_reply.out().write(pbase(), pptr() - pbase());
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+        m_reply.out().flush();
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (!m_started) {
+            m_reply.setDirectMode();
+            m_started = true;
+        }
+
+        if (!m_reply.out().write(pbase(), pptr() - pbase())) {
+            return traits_type::eof();
+        }
+        setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    tnt::HttpReply&   m_reply;
+    std::vector<char> m_buffer;
+    bool              m_started = false;
+};
+
 unsigned Export::run()
 {
     rest::User user(m_request);
@@ -44,15 +97,24 @@ unsigned Export::run()
             tnt::httpheader::contentDisposition, "attachment; filename=\"asset_export" + strTime + ".csv\"");
     }
 
-    auto ret = AssetManager::exportCsv(dcAsset);
-    if (ret) {
-        m_reply.setContentType("text/csv;charset=UTF-8");
-        m_reply << "\xef\xbb\xbf";
-        m_reply << *ret;
-    } else {
-        throw rest::errors::Internal(ret.error());
+    m_reply.setContentType("text/csv;charset=UTF-8");
+
+    ReplyBuffer  buffer(m_reply);
+    std::ostream out(&buffer);
+    out << "\xef\xbb\xbf";
+
+    auto ret = AssetManager::exportCsv(out, dcAsset);
+    if (!ret) {
+        if (!buffer.isStarted()) {
+            throw rest::errors::Internal(ret.error());
+        }
+        // Headers and a part of the file are already sent, the connection is aborted, so the client doesn't take
+        // the truncated file for a complete one
+        logError("Export failed after the reply was started: {}", ret.error().toString());
+        throw std::runtime_error("asset export aborted: " + ret.error().toString());
     }
 
+    buffer.finish();
     return HTTP_OK;
 }
 
@@ -0,0 +1,99 @@
+#include "import-job.h"
+#include "asset/asset-import-jobs.h"
+#include <fty/rest/audit-log.h>
+#include <fty/rest/component.h>
+
+namespace fty::asset {
+
+struct JobStatus : public pack::Node
+{
+    pack::String                       job           = FIELD("job");
+    pack::String                       state         = FIELD("state");
+    pack::UInt32                       rowsDone      = FIELD("rows_done");
+    pack::UInt32                       rowsFailed    = FIELD("rows_failed");
+    pack::UInt32                       rowsPerSecond = FIELD("rows_per_second");
+    pack::String                       error         = FIELD("error");
+    pack::Int32                        okLines       = FIELD("imported_lines");
+    pack::ObjectList<pack::StringList> errors        = FIELD("errors");
+
+    using pack::Node::Node;
+    META(JobStatus, job, state, rowsDone, rowsFailed, rowsPerSecond, error, okLines, errors);
+};
+
+static std::string stateName(ImportJobs::State state)
+{
+    switch (state) {
+        case ImportJobs::State::Queued:
+            return "queued";
+        case ImportJobs::State::Running:
+            return "running";
+        case ImportJobs::State::Finished:
+            return "finished";
+        case ImportJobs::State::Cancelled:
+            return "cancelled";
+        case ImportJobs::State::Failed:
+            return "failed";
+    }
+    return {};
+}
+
+unsigned RestImportJob::run()
+{
+    rest::User user(m_request);
+
+    bool cancel = m_request.type() == rest::Request::Type::Delete;
+    if (!cancel && m_request.type() != rest::Request::Type::Get) {
+        throw rest::errors::MethodNotAllowed(m_request.type());
+    }
+    if (auto ret = checkPermissions(user.profile(), cancel ? m_cancelPermissions : m_permissions); !ret) {
+        throw rest::Error(ret.error());
+    }
+
+    Expected<std::string> id = m_request.queryArg<std::string>("job");
+    if (!id) {
+        throw rest::errors::RequestParamRequired("job");
+    }
+
+    // the job is stopped between rows, the rows imported so far stay imported
+    if (cancel) {
+        if (!ImportJobs::instance().cancel(*id)) {
+            auditError("Request DELETE asset_import job {} FAILED"_tr, *id);
+            throw rest::errors::ElementNotFound(*id);
+        }
+        auditInfo("Request DELETE asset_import job {} SUCCESS", *id);
+    }
+
+    auto status = ImportJobs::instance().status(*id);
+    if (!status) {
+        throw rest::errors::ElementNotFound(*id);
+    }
+
+    JobStatus ret;
+    ret.job           = *id;
+    ret.state         = stateName(status->state);
+    ret.rowsDone      = uint32_t(status->rowsDone);
+    ret.rowsFailed    = uint32_t(status->rowsFailed);
+    ret.rowsPerSecond = uint32_t(status->rowsPerSecond);
+    if (status->error) {
+        ret.error = status->error->toString();
+    }
+    if (status->items) {
+        for (const auto& [row, el] : *status->items) {
+            if (el) {
+                ret.okLines = ret.okLines + 1;
+            } else {
+                pack::StringList err;
+                err.append(fty::convert<std::string>(row));
+                err.append(el.error());
+                ret.errors.append(err);
+            }
+        }
+    }
+
+    m_reply << *pack::json::serialize(ret);
+    return HTTP_OK;
+}
+
+} // namespace fty::asset
+
+registerHandler(fty::asset::RestImportJob)
@@ -1,5 +1,7 @@
 #include "import.h"
+#include "asset/asset-import-jobs.h"
 #include "asset/asset-manager.h"
+#include "asset/env.h"
 #include <fty/rest/audit-log.h>
 #include <fty/rest/component.h>
 
@@ -14,6 +16,42 @@ struct Result : public pack::Node
     META(Result, okLines, errors);
 };
 
+struct Job : public pack::Node
+{
+    pack::String job = FIELD("job");
+
+    using pack::Node::Node;
+    META(Job, job);
+};
+
+struct Rejected : public pack::Node
+{
+    pack::String error = FIELD("error");
+
+    using pack::Node::Node;
+    META(Rejected, error);
+};
+
+struct Validation : public pack::Node
+{
+    pack::Int32                        validLines = FIELD("valid_lines");
+    pack::ObjectList<pack::StringList> errors     = FIELD("errors");
+
+    using pack::Node::Node;
+    META(Validation, validLines, errors);
+};
+
+static constexpr const char* ENV_IMPORT_MAX_SIZE     = "FTY_ASSET_IMPORT_MAX_SIZE";
+static constexpr size_t      DEFAULT_IMPORT_MAX_SIZE = 32 * 1024;
+
+// Size of the import request in KiB (FTY_ASSET_IMPORT_MAX_SIZE, 0 is not limited). The import is limited by its row
+// and time budget, this only rejects requests far bigger than any document within the budget (100000 rows)
+static size_t maxContentSize()
+{
+    static const size_t size = envNumber(ENV_IMPORT_MAX_SIZE, DEFAULT_IMPORT_MAX_SIZE);
+    return size;
+}
+
 unsigned RestImport::run()
 {
     rest::User user(m_request);
@@ -21,17 +59,24 @@ unsigned RestImport::run()
         throw rest::Error(ret.error());
     }
 
-    // HARDCODED limit: can't import things larger than 128K
-    // this prevents DoS attacks against the box - can be raised if needed
-    // don't forget internal processing is in UCS-32, therefore the
-    // real memory requirements are ~640kB
-    // Content size = body + something. So max size of body is about 125k
-    if (m_request.contentSize() > 128 * 1024) {
-        auditError("Request CREATE asset_import FAILED {}"_tr, "can't import things larger than 128K"_tr);
-        throw rest::errors::ContentTooBig("128k");
+    // The document is parsed in place and imported in parts of rows, within the row and time budget of the import
+    if (maxContentSize() && m_request.contentSize() > maxContentSize() * 1024) {
+        auditError("Request CREATE asset_import FAILED {}"_tr,
+            "can't import things larger than {}K"_tr.format(maxContentSize()));
+        throw rest::errors::ContentTooBig(std::to_string(maxContentSize()) + "k");
     }
 
     if (auto part = m_request.multipart("assets")) {
+        // dry run validates the whole document at once, nothing is written
+        if (auto dryRun = m_request.queryArg<std::string>("dry_run"); dryRun && *dryRun == "true") {
+            return validate(*part, user.login());
+        }
+
+        // on request, the document is imported in the background, the progress is reported by asset/import/{job}
+        if (auto async = m_request.queryArg<std::string>("async"); async && *async == "true") {
+            return submit(std::move(*part), user.login());
+        }
+
         auto res = AssetManager::importCsv(*part, user.login());
         if (!res) {
             throw rest::errors::Internal(res.error());
@@ -55,6 +100,47 @@ unsigned RestImport::run()
     }
 }
 
+unsigned RestImport::submit(std::string&& csv, const std::string& user)
+{
+    auto id = ImportJobs::instance().submit(std::move(csv), user);
+    if (!id) {
+        auditError("Request CREATE asset_import FAILED {}"_tr, id.error());
+        Rejected rejected;
+        rejected.error = id.error();
+        m_reply << *pack::json::serialize(rejected);
+        return HTTP_SERVICE_UNAVAILABLE;
+    }
+    auditInfo("Request CREATE asset_import job {} SUCCESS", *id);
+
+    Job job;
+    job.job = *id;
+    m_reply << *pack::json::serialize(job);
+    return HTTP_ACCEPTED;
+}
+
+unsigned RestImport::validate(const std::string& csv, const std::string& user)
+{
+    auto res = AssetManager::validateCsv(csv, user);
+    if (!res) {
+        auditError("Request CREATE asset_import dry run FAILED {}"_tr, res.error());
+        throw rest::errors::Internal(res.error());
+    }
+
+    Validation result;
+    for (const auto& [row, el] : *res) {
+        if (el) {
+            result.validLines = result.validLines + 1;
+        } else {
+            pack::StringList err;
+            err.append(fty::convert<std::string>(row));
+            err.append(el.error());
+            result.errors.append(err);
+        }
+    }
+    m_reply << *pack::json::serialize(result);
+    return HTTP_OK;
+}
+
 } // namespace fty::asset
 
 registerHandler(fty::asset::RestImport)
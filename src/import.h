@@ -32,6 +32,10 @@ public:
 public:
     unsigned run() override;
 
+private:
+    unsigned submit(std::string&& csv, const std::string& user);
+    unsigned validate(const std::string& csv, const std::string& user);
+
 private:
     // clang-format off
     Permissions m_permissions = {
@@ -1,13 +1,18 @@
 #include "list.h"
 #include "asset/asset-db.h"
+#include "asset/asset-dictionary.h"
 #include "asset/asset-manager.h"
 #include <fty/split.h>
 #include <fty_common_asset_types.h>
 #include <pack/pack.h>
+#include <algorithm>
 #include <fty/rest/component.h>
 
 namespace fty::asset {
 
+// Number of assets whose names are resolved at once
+static constexpr size_t LIST_PAGE_SIZE = 1024;
+
 struct Info : public pack::Node
 {
     pack::UInt32 id   = FIELD("id");
@@ -35,7 +40,12 @@ unsigned List::run()
         throw rest::errors::RequestParamRequired("type");
     }
 
-    if (!persist::type_to_typeid(*assetType)) {
+    auto dictionary = db::Dictionary::instance().snapshot();
+    if (!dictionary) {
+        throw rest::errors::Internal(dictionary.error());
+    }
+
+    if (!(*dictionary)->typeId(*assetType)) {
         throw rest::errors::RequestParamBad("type", *assetType, "datacenter/room/row/rack/group/device");
     }
 
@@ -43,7 +53,7 @@ unsigned List::run()
     if (subtype) {
         subtypes = split(*subtype, ",");
         for (const auto& it : subtypes) {
-            if (!persist::subtype_to_subtypeid(it)) {
+            if (!(*dictionary)->subtypeId(it)) {
                 throw rest::errors::RequestParamBad("subtype", *subtype, "See RFC-11 for possible values"_tr);
             }
         }
@@ -59,16 +69,36 @@ unsigned List::run()
             throw rest::errors::Internal(allAssetsShort.error());
         }
 
-        for (const auto& [id, name] : *allAssetsShort) {
-            auto assetNames = db::idToNameExtName(id);
+        // Names are resolved by pages, so they are not held for all the assets next to the reply
+        std::vector<uint32_t> ids;
+        ids.reserve(std::min(allAssetsShort->size(), LIST_PAGE_SIZE));
+
+        auto appendPage = [&]() {
+            auto assetNames = db::idToNameExtName(ids);
             if (!assetNames) {
                 throw rest::errors::Internal("Database failure"_tr);
             }
 
-            auto& ins = val.append();
-            ins.id    = id;
-            ins.name  = assetNames->second;
+            for (uint32_t id : ids) {
+                auto names = assetNames->find(id);
+                if (names == assetNames->end()) {
+                    throw rest::errors::Internal("Database failure"_tr);
+                }
+
+                auto& ins = val.append();
+                ins.id    = id;
+                ins.name  = names->second.second;
+            }
+            ids.clear();
+        };
+
+        for (const auto& it : *allAssetsShort) {
+            ids.push_back(it.first);
+            if (ids.size() == LIST_PAGE_SIZE) {
+                appendPage();
+            }
         }
+        appendPage();
     }
 
     m_reply << *pack::json::serialize(ret);
@@ -0,0 +1,104 @@
+#include "asset/csv.h"
+#include <catch2/catch.hpp>
+#include <sstream>
+
+TEST_CASE("Csv parser")
+{
+    SECTION("Quoted values")
+    {
+        auto cm = fty::asset::CsvMap_from_string(
+            "\xef\xbb\xbfname,type,description\r\n\"Rack, 1\",rack,\"say \"\"hi\"\"\nthere\"\n\nRoom,room,\n");
+
+        REQUIRE(cm.rows() == 3);
+        CHECK(cm.cols() == 3);
+        CHECK(cm.get(1, "name") == "Rack, 1");
+        CHECK(cm.get(1, "description") == "say \"hi\"\nthere");
+        CHECK(cm.get(2, "name") == "Room");
+        CHECK(cm.view(2, "description").empty());
+    }
+
+    SECTION("Delimiter")
+    {
+        std::string longName(100, 'x');
+        auto        cm = fty::asset::CsvMap_from_string("name;type\n" + longName + ";'it''s'");
+
+        REQUIRE(cm.rows() == 2);
+        CHECK(cm.get(1, "name") == longName);
+        CHECK(cm.get(1, "type") == "it's");
+    }
+
+    SECTION("Column handles")
+    {
+        auto cm = fty::asset::CsvMap_from_string("Name,Type\nrack-1,rack\nshort\n");
+
+        auto name = cm.column("name");
+        auto type = cm.column("TYPE");
+        CHECK(!cm.findColumn("location"));
+        CHECK_THROWS_AS(cm.column("location"), std::out_of_range);
+
+        auto row = cm.row(1);
+        CHECK(row[name] == "rack-1");
+        CHECK(row[type] == "rack");
+        CHECK(cm.get_strip(1, type) == "rack");
+        CHECK(cm.row(2)[name] == "short");
+        CHECK_THROWS_AS(cm.row(2)[type], std::out_of_range);
+    }
+
+    SECTION("Dialect")
+    {
+        auto dialect = fty::asset::sniffDialect("name;type,x;status\r\na;b,c;d\r\ne;f;g;h\r\n");
+        CHECK(dialect.delimiter == ';');
+        CHECK(dialect.confidence > 0.6);
+        CHECK(dialect.quote == '"');
+        CHECK(dialect.lineEnding == fty::asset::CsvDialect::LineEnding::CrLf);
+
+        // Excel "Unicode text" export: UTF-16LE with BOM, tab separated
+        std::string utf16 = "\xff\xfe";
+        for (char c : std::string("name\ttype\r\nR\xe9seau\track\r\n")) {
+            utf16 += c;
+            utf16 += '\0';
+        }
+        dialect = fty::asset::sniffDialect(utf16);
+        CHECK(dialect.bom);
+        CHECK(dialect.encoding == fty::asset::CsvDialect::Encoding::Utf16LE);
+        CHECK(dialect.delimiter == '\t');
+
+        auto cm = fty::asset::CsvMap_from_string(utf16);
+        REQUIRE(cm.rows() == 2);
+        CHECK(cm.get(1, "name") == "R\xc3\xa9seau");
+        CHECK(cm.get(1, "type") == "rack");
+    }
+
+    SECTION("Parts")
+    {
+        std::stringstream doc;
+        doc << "\xef\xbb\xbfname,description\r\n";
+        for (int i = 1; i <= 10; ++i) {
+            doc << "rack-" << i << ",\"multi\nline, " << i << "\"\r\n";
+        }
+        doc << "rack-11,last";
+
+        // small blocks split the records, every part starts with the titles
+        fty::asset::CsvReader reader(doc, 16);
+        std::vector<std::string> names;
+        while (auto part = reader.next(4)) {
+            REQUIRE(part->rows() > 1);
+            CHECK(part->rows() <= 5);
+            CHECK(part->get(0, "name") == "name");
+            for (size_t row = 1; row < part->rows(); ++row) {
+                names.push_back(part->get(row, "name"));
+            }
+        }
+        REQUIRE(names.size() == 11);
+        CHECK(names.front() == "rack-1");
+        CHECK(names.back() == "rack-11");
+        CHECK(reader.dialect().bom);
+    }
+
+    SECTION("Invalid documents")
+    {
+        CHECK_THROWS_AS(fty::asset::CsvMap_from_string("name,type\n\"rack,rack"), std::invalid_argument);
+        CHECK_THROWS_AS(fty::asset::CsvMap_from_string("name,type\n\xff,rack"), std::invalid_argument);
+        CHECK_THROWS_AS(fty::asset::CsvMap_from_string("name type"), std::invalid_argument);
+    }
+}
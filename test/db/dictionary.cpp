@@ -0,0 +1,42 @@
+#include "asset/asset-dictionary.h"
+#include "asset/db.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Asset dictionary")
+{
+    auto& dictionary = fty::asset::db::Dictionary::instance();
+    dictionary.invalidate();
+
+    auto snapshot = dictionary.snapshot();
+    if (!snapshot) {
+        FAIL(snapshot.error());
+    }
+
+    SECTION("lookup")
+    {
+        CHECK((*snapshot)->typeId("datacenter"));
+        CHECK((*snapshot)->subtypeId("ups"));
+        CHECK(!(*snapshot)->typeId("spaceship"));
+        CHECK(!(*snapshot)->subtypeId("spaceship"));
+
+        auto again = dictionary.snapshot();
+        REQUIRE(again);
+        CHECK(again->get() == snapshot->get());
+    }
+
+    SECTION("reload")
+    {
+        tnt::Connection conn;
+        conn.execute(R"(INSERT INTO t_bios_asset_device_type (name) VALUES ("rack controller"))");
+
+        dictionary.invalidate();
+        auto reloaded = dictionary.snapshot();
+        REQUIRE(reloaded);
+        CHECK((*reloaded)->version != (*snapshot)->version);
+        CHECK((*reloaded)->subtypeId("rc") == (*reloaded)->subtypeId("rack controller"));
+        CHECK(!(*snapshot)->subtypeId("rc"));
+
+        conn.execute(R"(DELETE FROM t_bios_asset_device_type WHERE name = "rack controller")");
+        dictionary.invalidate();
+    }
+}
@@ -73,7 +73,38 @@ TEST_CASE("Asset/insert")
                         FAIL(res2.error());
                     }
                     REQUIRE(res2);
-                    CHECK(res2->size() == 1);
+                    REQUIRE(res2->size() == 1);
+                    CHECK((*res2)[0].srcId == el.id);
+                    CHECK((*res2)[0].destId == el2.id);
+                    CHECK((*res2)[0].srcName == el.name);
+                }
+
+                SECTION("insertAssetLinks")
+                {
+                    using fty::asset::db::LinkOutcome;
+
+                    fty::asset::db::AssetLink ported = link;
+                    ported.srcOut = "1";
+                    ported.destIn = "2";
+
+                    fty::asset::db::AssetLink invalid = link;
+                    invalid.src = 0;
+
+                    auto res3 = fty::asset::db::insertAssetLinks(conn, {ported, ported, invalid});
+                    if (!res3) {
+                        FAIL(res3.error());
+                    }
+                    REQUIRE(res3->size() == 3);
+                    CHECK((*res3)[0] == LinkOutcome::Inserted);
+                    CHECK((*res3)[1] == LinkOutcome::Skipped);
+                    CHECK((*res3)[2] == LinkOutcome::Invalid);
+
+                    auto res4 = fty::asset::db::insertAssetLinks(conn, {ported});
+                    if (!res4) {
+                        FAIL(res4.error());
+                    }
+                    REQUIRE(res4->size() == 1);
+                    CHECK((*res4)[0] == LinkOutcome::Skipped);
                 }
 
                 auto res2 = fty::asset::db::deleteAssetLinksTo(conn, el2.id);
@@ -225,3 +256,146 @@ TEST_CASE("Monitor")
     }
     REQUIRE(*ret2 > 0);
 }
+
+TEST_CASE("Asset/Ext attributes batches")
+{
+    tnt::Connection conn;
+
+    fty::asset::db::AssetElement el;
+    el.name      = "device";
+    el.status    = "active";
+    el.priority  = 1;
+    el.subtypeId = persist::subtype_to_subtypeid("ups");
+    el.typeId    = persist::type_to_typeid("device");
+
+    auto ret = fty::asset::db::insertIntoAssetElement(conn, el, true);
+    if (!ret) {
+        FAIL(ret.error());
+    }
+    el.id = *ret;
+
+    CHECK(tnt::batchSizes(77) == std::vector<size_t>{64, 8, 4, 1});
+    CHECK(tnt::inListSize(5) == 8);
+
+    // 77 attributes are inserted by 4 statements
+    std::map<std::string, std::string> attrs;
+    for (int i = 0; i < 77; ++i) {
+        attrs.emplace(fmt::format("key.{}", i), std::to_string(i));
+    }
+
+    auto ins = fty::asset::db::insertIntoAssetExtAttributes(conn, el.id, attrs, false);
+    if (!ins) {
+        FAIL(ins.error());
+    }
+
+    auto sel = fty::asset::db::selectExtAttributes(el.id);
+    if (!sel) {
+        FAIL(sel.error());
+    }
+    CHECK(sel->size() == 77);
+    CHECK((*sel)["key.76"].value == "76");
+
+    auto del = fty::asset::db::deleteAssetExtAttributesWithRo(conn, el.id, false);
+    if (!del) {
+        FAIL(del.error());
+    }
+    CHECK(*del == 77);
+
+    auto ret2 = fty::asset::db::deleteAssetElement(conn, el.id);
+    if (!ret2) {
+        FAIL(ret2.error());
+    }
+    REQUIRE(*ret2 > 0);
+}
+
+TEST_CASE("Asset/Bulk delete")
+{
+    tnt::Connection conn;
+
+    auto insert = [&](const std::string& name, const std::string& type, const std::string& subtype, uint32_t parent) {
+        fty::asset::db::AssetElement el;
+        el.name      = name;
+        el.status    = "nonactive";
+        el.priority  = 1;
+        el.typeId    = persist::type_to_typeid(type);
+        el.subtypeId = subtype.empty() ? 0 : persist::subtype_to_subtypeid(subtype);
+        el.parentId  = parent;
+
+        auto ret = fty::asset::db::insertIntoAssetElement(conn, el, true);
+        if (!ret) {
+            FAIL(ret.error());
+        }
+        return *ret;
+    };
+
+    uint32_t room = insert("room", "room", "", 0);
+    uint32_t ups  = insert("ups", "device", "ups", room);
+    uint32_t epdu = insert("epdu", "device", "epdu", room);
+
+    fty::asset::db::AssetLink link;
+    link.src  = ups;
+    link.dest = epdu;
+    link.type = 1;
+    REQUIRE(fty::asset::db::insertIntoAssetLink(conn, link));
+    REQUIRE(fty::asset::db::insertIntoAssetExtAttributes(conn, epdu, {{"logical_asset", "ups"}}, false));
+
+    {
+        auto res = fty::asset::db::selectAssetElementsWebByIds(conn, {room, ups, epdu, uint32_t(-1)});
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(res->size() == 3);
+    }
+
+    {
+        auto res = fty::asset::db::selectAssetDeviceLinksSrc(conn, std::vector<uint32_t>{ups, epdu});
+        if (!res) {
+            FAIL(res.error());
+        }
+        REQUIRE(res->size() == 1);
+        CHECK((*res)[ups] == std::vector<uint32_t>{epdu});
+    }
+
+    {
+        auto res = fty::asset::db::selectKeytagOwners(conn, "logical_asset", {"ups", "room"});
+        if (!res) {
+            FAIL(res.error());
+        }
+        REQUIRE(res->size() == 1);
+        CHECK((*res)["ups"] == std::vector<uint32_t>{epdu});
+    }
+
+    // Clean up, relations first, then children before their parent
+    {
+        auto res = fty::asset::db::deleteAssetGroupRelations(conn, {room, ups, epdu});
+        if (!res) {
+            FAIL(res.error());
+        }
+    }
+
+    {
+        auto res = fty::asset::db::deleteAssetLinks(conn, {room, ups, epdu});
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(*res == 1);
+    }
+
+    REQUIRE(fty::asset::db::deleteAssetExtAttributesWithRo(conn, epdu, false));
+
+    {
+        auto res = fty::asset::db::deleteAssetElements(conn, {ups, epdu});
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(*res == 2);
+    }
+
+    {
+        auto res = fty::asset::db::deleteAssetElements(conn, {room});
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(*res == 1);
+    }
+}
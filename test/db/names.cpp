@@ -92,6 +92,71 @@ TEST_CASE("Asset names")
         REQUIRE(id.error() == "Element 'Some shit' not found.");
     }
 
+    SECTION("idToNameExtName/batch")
+    {
+        auto names = fty::asset::db::idToNameExtName(std::vector<uint32_t>{*ret, uint32_t(-1), *ret});
+        if (!names) {
+            FAIL(names.error());
+        }
+        REQUIRE(names->size() == 1);
+        REQUIRE(names->at(*ret).first == "device");
+        REQUIRE(names->at(*ret).second == "Device name");
+    }
+
+    SECTION("nameToExtName/batch")
+    {
+        auto names = fty::asset::db::nameToExtName(std::vector<std::string>{"device", "_device"});
+        if (!names) {
+            FAIL(names.error());
+        }
+        REQUIRE(names->size() == 1);
+        REQUIRE(names->at("device") == "Device name");
+    }
+
+    SECTION("resolveAssetNames")
+    {
+        auto entries = fty::asset::db::resolveAssetNames({"device", "Device name", "unknown"});
+        if (!entries) {
+            FAIL(entries.error());
+        }
+        REQUIRE(entries->size() == 2);
+        for (const auto& entry : *entries) {
+            CHECK(entry.id == *ret);
+            CHECK(entry.name == "device");
+            CHECK(entry.extName == "Device name");
+        }
+    }
+
+    SECTION("name index/rename")
+    {
+        // Fill the index
+        REQUIRE(fty::asset::db::extNameToAssetName("Device name"));
+
+        auto del = fty::asset::db::deleteAssetExtAttributesWithRo(conn, *ret, true);
+        if (!del) {
+            FAIL(del.error());
+        }
+        auto ins = fty::asset::db::insertIntoAssetExtAttributes(conn, *ret, {{"name", "Renamed device"}}, true);
+        if (!ins) {
+            FAIL(ins.error());
+        }
+
+        CHECK(!fty::asset::db::extNameToAssetName("Device name"));
+
+        auto id = fty::asset::db::idToNameExtName(*ret);
+        if (!id) {
+            FAIL(id.error());
+        }
+        CHECK(id->first == "device");
+        CHECK(id->second == "Renamed device");
+
+        auto byExt = fty::asset::db::extNameToAssetId("Renamed device");
+        if (!byExt) {
+            FAIL(byExt.error());
+        }
+        CHECK(*byExt == *ret);
+    }
+
     // Clean up
     {
         auto res = fty::asset::db::deleteAssetExtAttributesWithRo(conn, *ret, true);
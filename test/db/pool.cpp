@@ -0,0 +1,42 @@
+#include "asset/db.h"
+#include <catch2/catch.hpp>
+#include <memory>
+#include <thread>
+
+TEST_CASE("Connection pool")
+{
+    auto& pool   = tnt::ConnectionPool::instance();
+    auto  before = pool.stats();
+
+    SECTION("release by another thread")
+    {
+        auto conn = std::make_unique<tnt::Connection>();
+        CHECK(conn->selectRow("SELECT 1 AS one").get<int>("one") == 1);
+        CHECK(pool.stats().inUse == before.inUse + 1);
+
+        std::thread([&]() {
+            conn.reset();
+        }).join();
+        CHECK(pool.stats().inUse == before.inUse);
+
+        tnt::Connection again;
+        CHECK(again.selectRow("SELECT 1 AS one").get<int>("one") == 1);
+        CHECK(pool.stats().inUse == before.inUse + 1);
+        CHECK(pool.stats().overflows == before.overflows);
+    }
+
+    SECTION("release of a connection acquired by another thread")
+    {
+        std::unique_ptr<tnt::Connection> conn;
+        std::thread([&]() {
+            conn = std::make_unique<tnt::Connection>();
+        }).join();
+        CHECK(pool.stats().inUse == before.inUse + 1);
+
+        conn.reset();
+        CHECK(pool.stats().inUse == before.inUse);
+        CHECK(pool.stats().overflows == before.overflows);
+    }
+
+    CHECK(pool.stats().inUse == before.inUse);
+}
@@ -1,6 +1,7 @@
 #include "asset/asset-db.h"
 #include "asset/db.h"
 #include <catch2/catch.hpp>
+#include <algorithm>
 #include <fty_common_asset_types.h>
 
 TEST_CASE("Select asset")
@@ -161,6 +162,81 @@ TEST_CASE("Select asset")
         CHECK(res->size() == 1);
     }
 
+    SECTION("selectExtAttributesByIds")
+    {
+        auto res = fty::asset::db::selectExtAttributesByIds(conn, {el.id, gr.id});
+        if (!res) {
+            FAIL(res.error());
+        }
+        REQUIRE(res->count(el.id) == 1);
+        CHECK((*res)[el.id]["name"].value == "Device name");
+        CHECK((*res)[el.id]["name"].readOnly == true);
+    }
+
+    SECTION("selectAssetGroupsByIds")
+    {
+        auto res = fty::asset::db::selectAssetGroupsByIds(conn, {el.id});
+        if (!res) {
+            FAIL(res.error());
+        }
+        REQUIRE(res->count(el.id) == 1);
+        CHECK((*res)[el.id] == std::vector<uint32_t>{gr.id});
+    }
+
+    SECTION("selectAssetDeviceLinksToByIds")
+    {
+        auto res = fty::asset::db::selectAssetDeviceLinksToByIds(conn, {el.id}, INPUT_POWER_CHAIN);
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(res->empty());
+    }
+
+    SECTION("selectAssetElementPage")
+    {
+        std::vector<uint32_t> ids;
+        uint32_t              last = 0;
+        while (true) {
+            auto res = fty::asset::db::selectAssetElementPage(conn, last, 1);
+            if (!res) {
+                FAIL(res.error());
+            }
+            if (res->empty()) {
+                break;
+            }
+            REQUIRE(res->size() == 1);
+            CHECK(res->front().id > last);
+            last = res->front().id;
+            ids.push_back(last);
+        }
+        CHECK(std::count(ids.begin(), ids.end(), el.id) == 1);
+        CHECK(std::count(ids.begin(), ids.end(), gr.id) == 1);
+    }
+
+    SECTION("selectAssetElementAll/stream")
+    {
+        std::vector<uint32_t> ids;
+
+        auto res = fty::asset::db::selectAssetElementAll(conn, std::nullopt, [&](const auto& row) {
+            ids.push_back(row.id);
+            return true;
+        });
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(std::find(ids.begin(), ids.end(), el.id) != ids.end());
+        CHECK(std::find(ids.begin(), ids.end(), gr.id) != ids.end());
+
+        size_t count = 0;
+        res = fty::asset::db::selectAssetElementAll(conn, std::nullopt, [&](const auto& /*row*/) {
+            return ++count < 1;
+        });
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(count == 1);
+    }
+
     // Clean up
     {
         auto res = fty::asset::db::deleteAssetGroupLinks(conn, gr.id);
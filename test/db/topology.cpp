@@ -0,0 +1,141 @@
+#include "asset/asset-db.h"
+#include "asset/asset-topology.h"
+#include "asset/db.h"
+#include <catch2/catch.hpp>
+#include <fty_common_asset_types.h>
+
+static uint32_t insertElement(tnt::Connection& conn, fty::asset::db::AssetElement& el)
+{
+    auto ret = fty::asset::db::insertIntoAssetElement(conn, el, true);
+    if (!ret) {
+        FAIL(ret.error());
+    }
+    REQUIRE(*ret > 0);
+    el.id = *ret;
+    return el.id;
+}
+
+TEST_CASE("Asset topology")
+{
+    tnt::Connection conn;
+
+    fty::asset::db::AssetElement dc;
+    dc.name     = "datacenter";
+    dc.status   = "active";
+    dc.priority = 1;
+    dc.typeId   = persist::type_to_typeid("datacenter");
+    insertElement(conn, dc);
+
+    fty::asset::db::AssetElement room;
+    room.name     = "room";
+    room.status   = "active";
+    room.priority = 1;
+    room.typeId   = persist::type_to_typeid("room");
+    room.parentId = dc.id;
+    insertElement(conn, room);
+
+    fty::asset::db::AssetElement ups;
+    ups.name      = "ups";
+    ups.status    = "active";
+    ups.priority  = 1;
+    ups.typeId    = persist::type_to_typeid("device");
+    ups.subtypeId = persist::subtype_to_subtypeid("ups");
+    ups.parentId  = room.id;
+    insertElement(conn, ups);
+
+    SECTION("ancestors")
+    {
+        fty::asset::db::Topology topology(conn);
+
+        auto parents = topology.ancestors(ups.id);
+        REQUIRE(parents.size() == 2);
+        CHECK(parents[0].id == room.id);
+        CHECK(parents[0].name == "room");
+        CHECK(parents[1].id == dc.id);
+        CHECK(parents[1].typeId == persist::type_to_typeid("datacenter"));
+
+        auto node = topology.node(ups.id);
+        REQUIRE(node);
+        CHECK(node->parentId == room.id);
+        CHECK(!topology.node(ups.id + 1000));
+    }
+
+    SECTION("descendants")
+    {
+        fty::asset::db::Topology topology(conn);
+
+        CHECK(topology.descendants(dc.id).size() == 2);
+        CHECK(topology.subtree(dc.id).count(ups.id) == 1);
+        CHECK(topology.children(dc.id).size() == 1);
+
+        fty::asset::db::Topology::Filter filter;
+        filter.types    = {persist::type_to_typeid("device")};
+        filter.subtypes = {persist::subtype_to_subtypeid("ups")};
+        filter.status   = "active";
+
+        auto devices = topology.descendants(dc.id, filter);
+        REQUIRE(devices.size() == 1);
+        CHECK(devices[0].id == ups.id);
+
+        std::vector<std::string> names;
+        auto res = fty::asset::db::selectAssetsByContainer(conn, dc.id, filter.types, filter.subtypes, "", "active",
+            [&](const tnt::Row& row) {
+                names.push_back(row.get("name"));
+            });
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(names == std::vector<std::string>{"ups"});
+    }
+
+    SECTION("update")
+    {
+        auto res = fty::asset::db::updateAssetElement(conn, ups.id, dc.id, "nonactive", 1, "");
+        if (!res) {
+            FAIL(res.error());
+        }
+
+        fty::asset::db::Topology topology(conn);
+
+        auto parents = topology.ancestors(ups.id);
+        REQUIRE(parents.size() == 1);
+        CHECK(parents[0].id == dc.id);
+        CHECK(topology.descendants(room.id).empty());
+
+        fty::asset::db::Topology::Filter filter;
+        filter.status = "active";
+        CHECK(topology.descendants(dc.id, filter).size() == 1);
+    }
+
+    SECTION("transaction")
+    {
+        // Tree read through the connection of a transaction sees its changes, other connections don't
+        tnt::Transaction trans(conn);
+        auto res = fty::asset::db::updateAssetElement(conn, ups.id, dc.id, "active", 1, "");
+        if (!res) {
+            FAIL(res.error());
+        }
+        CHECK(fty::asset::db::Topology(conn).ancestors(ups.id).size() == 1);
+
+        {
+            tnt::Connection other;
+            CHECK(fty::asset::db::Topology(other).ancestors(ups.id).size() == 2);
+        }
+        trans.rollback();
+
+        CHECK(fty::asset::db::Topology(conn).ancestors(ups.id).size() == 2);
+    }
+
+    // Clean up
+    for (uint32_t id : {ups.id, room.id, dc.id}) {
+        auto res = fty::asset::db::deleteAssetElement(conn, id);
+        if (!res) {
+            FAIL(res.error());
+        }
+        REQUIRE(*res > 0);
+    }
+
+    fty::asset::db::Topology topology(conn);
+    CHECK(!topology.node(ups.id));
+    CHECK(topology.descendants(dc.id).empty());
+}
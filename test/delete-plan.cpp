@@ -0,0 +1,55 @@
+#include "asset/asset-delete-plan.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("Delete plan")
+{
+    static const fty::Translate reason = "blocked"_tr;
+
+    fty::asset::DeletePlan plan;
+    // dc(1) <- room(2) <- rack(3) <- ups(4) -> pdu(5), ups powers pdu
+    for (uint32_t id : {1, 2, 3, 4, 5}) {
+        plan.addCandidate(id);
+    }
+    plan.require(1, 2, reason);
+    plan.require(2, 3, reason);
+    plan.require(3, 4, reason);
+    plan.require(3, 5, reason);
+    plan.require(4, 5, reason);
+
+    SECTION("Layers")
+    {
+        plan.build();
+        using Layers = fty::asset::DeletePlan::Layers;
+        CHECK(plan.layers() == Layers{{5}, {4}, {3}, {2}, {1}});
+        CHECK(plan.isDeletable(1));
+        CHECK(!plan.failure(1));
+    }
+
+    SECTION("Failure propagation")
+    {
+        plan.fail(4, "deactivation failed"_tr);
+        plan.build();
+        CHECK(plan.layers() == fty::asset::DeletePlan::Layers{{5}});
+        CHECK(!plan.isDeletable(4));
+        CHECK(!plan.isDeletable(1));
+        REQUIRE(plan.failure(3));
+        CHECK(plan.failure(3)->toString() == "blocked");
+    }
+
+    SECTION("Blocker is not deleted")
+    {
+        plan.require(5, 42, reason);
+        plan.build();
+        CHECK(plan.layers().empty());
+        CHECK(!plan.isCandidate(42));
+    }
+
+    SECTION("Cycle")
+    {
+        plan.require(5, 4, reason);
+        plan.build();
+        CHECK(plan.layers().empty());
+        CHECK(!plan.isDeletable(5));
+        CHECK(!plan.isDeletable(1));
+    }
+}
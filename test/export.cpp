@@ -16,5 +16,30 @@ TEST_CASE("Export asset")
         deleteAsset(el);
     }
 
+    SECTION("Export of datacenter")
+    {
+        fty::asset::db::AssetElement rack   = createAsset("rack", "Rack", "rack", dc.id);
+        fty::asset::db::AssetElement inRack = createAsset("device-rack", "Device in rack", "device", rack.id);
+        fty::asset::db::AssetElement other  = createAsset("datacenter-other", "Other data center", "datacenter");
+        fty::asset::db::AssetElement outDc  = createAsset("device-other", "Device outside", "device", other.id);
+
+        auto exp = fty::asset::AssetManager::exportCsv(dc);
+        if (!exp) {
+            FAIL(exp.error());
+        }
+
+        // everything located (at any level) in datacenter, the datacenter itself included
+        CHECK(exp->find("Data center,") != std::string::npos);
+        CHECK(exp->find("Rack,rack,") != std::string::npos);
+        CHECK(exp->find("Device in rack,device,") != std::string::npos);
+        CHECK(exp->find("Other data center") == std::string::npos);
+        CHECK(exp->find("Device outside") == std::string::npos);
+
+        deleteAsset(outDc);
+        deleteAsset(other);
+        deleteAsset(inRack);
+        deleteAsset(rack);
+    }
+
     deleteAsset(dc);
 }
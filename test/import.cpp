@@ -1,4 +1,8 @@
+#include "asset/asset-import-jobs.h"
+#include "asset/asset-import.h"
 #include "asset/asset-manager.h"
+#include "asset/asset-topology.h"
+#include "asset/csv.h"
 #include "test-utils.h"
 
 TEST_CASE("Import asset")
@@ -25,4 +29,342 @@ NewsFeed,device,feed,Washington DC,active,P1,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,1,,,
             deleteAsset(*el);
         }
     }
+
+    SECTION("Import with failing rows")
+    {
+        static std::string data = R"(name,type,sub_type,location,status,priority,id
+Washington DC,datacenter,,,active,P1,
+Room1,spaceship,,Washington DC,active,P1,
+Room2,room,,Washington DC,nonactive,P1,
+Room3,room,,Washington DC,active,P1,
+Row3,row,,Room3,active,P1,)";
+
+        auto ret = fty::asset::AssetManager::importCsv(data, "dummy", false);
+        if (!ret) {
+            FAIL(ret.error());
+        }
+        REQUIRE(ret->size() == 5);
+        CHECK(ret->at(1));
+        CHECK(!ret->at(2));
+        CHECK(!ret->at(3));
+        CHECK(ret->at(4));
+        CHECK(ret->at(5));
+
+        for (auto iter = ret->rbegin(); iter != ret->rend(); ++iter) {
+            if (iter->second) {
+                auto el = fty::asset::db::selectAssetElementWebById(*(iter->second));
+                deleteAsset(*el);
+            }
+        }
+    }
+
+    SECTION("Import with failing writes")
+    {
+        // rows fail once their asset element is written: the monitor device of 'Fail Monitor' is rejected, the ext
+        // attribute of 'Fail Room2' is rejected when the row is written or, in bulk mode, when the chunk is flushed
+        tnt::Connection conn;
+        conn.execute(R"(
+            CREATE TRIGGER fail_discovered_device BEFORE INSERT ON t_bios_discovered_device FOR EACH ROW
+            IF NEW.name = 'Fail Monitor' THEN
+                SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'discovered device rejected';
+            END IF
+        )");
+        conn.execute(R"(
+            CREATE TRIGGER fail_ext_attribute BEFORE INSERT ON t_bios_asset_ext_attributes FOR EACH ROW
+            IF NEW.keytag = 'note' AND NEW.value = 'reject' THEN
+                SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'ext attribute rejected';
+            END IF
+        )");
+
+        static std::string data = R"(name,type,sub_type,location,status,priority,note,id
+Fail DC,datacenter,,,active,P1,,
+Fail Monitor,datacenter,,,active,P1,,
+Fail Room1,room,,Fail DC,active,P1,,
+Fail Room2,room,,Fail DC,active,P1,reject,
+Fail Room3,room,,Fail DC,active,P1,,)";
+
+        auto count = [&](const std::string& sql) {
+            return conn.selectRow(sql).get<uint32_t>("cnt");
+        };
+
+        for (size_t chunk : {1, 64}) {
+            auto elements = count("SELECT COUNT(*) AS cnt FROM t_bios_asset_element");
+
+            auto               cm = fty::asset::CsvMap_from_string(data);
+            fty::asset::Import import(cm);
+            import.setChunkSize(chunk);
+            REQUIRE(import.process(false));
+
+            const auto& items = import.items();
+            REQUIRE(items.size() == 5);
+            CHECK(items.at(1));
+            CHECK(!items.at(2));
+            CHECK(items.at(3));
+            CHECK(!items.at(4));
+            CHECK(items.at(5));
+
+            // failed rows are rolled back entirely
+            CHECK(count("SELECT COUNT(*) AS cnt FROM t_bios_asset_element") == elements + 3);
+            CHECK(count(R"(
+                SELECT COUNT(*) AS cnt FROM t_bios_asset_ext_attributes
+                WHERE keytag = 'name' AND value IN ('Fail Monitor', 'Fail Room2')
+            )") == 0);
+
+            for (auto iter = items.rbegin(); iter != items.rend(); ++iter) {
+                if (iter->second) {
+                    auto el = fty::asset::db::selectAssetElementWebById(iter->second->id);
+                    REQUIRE(el);
+                    CHECK(el->name == iter->second->name);
+                    deleteAsset(*el);
+                }
+            }
+        }
+
+        conn.execute("DROP TRIGGER fail_discovered_device");
+        conn.execute("DROP TRIGGER fail_ext_attribute");
+    }
+
+    SECTION("Update by id")
+    {
+        static std::string data = R"(name,type,sub_type,location,status,priority,id
+Upd DC,datacenter,,,active,P1,
+Upd Room,room,,Upd DC,active,P1,)";
+
+        auto ret = fty::asset::AssetManager::importCsv(data, "dummy", false);
+        REQUIRE(ret);
+        REQUIRE(ret->size() == 2);
+        REQUIRE(ret->at(1));
+        REQUIRE(ret->at(2));
+        auto dc   = fty::asset::db::selectAssetElementWebById(*ret->at(1));
+        auto room = fty::asset::db::selectAssetElementWebById(*ret->at(2));
+        REQUIRE(dc);
+        REQUIRE(room);
+
+        // in bulk mode, the element of the id is read through the connection of the chunk
+        for (size_t chunk : {1, 64}) {
+            std::string update = "name,type,sub_type,location,status,priority,id\n";
+            update += "Upd DC,datacenter,,,active,P2," + dc->name + "\n";
+            update += "Upd Room,row,,Upd DC,active,P3," + room->name;
+
+            auto               cm = fty::asset::CsvMap_from_string(update);
+            fty::asset::Import import(cm);
+            import.setChunkSize(chunk);
+            REQUIRE(import.process(false));
+
+            const auto& items = import.items();
+            REQUIRE(items.size() == 2);
+            CHECK(items.at(1));
+            CHECK(!items.at(2));
+
+            auto updated = fty::asset::db::selectAssetElementWebById(dc->id);
+            REQUIRE(updated);
+            CHECK(updated->priority == 2);
+
+            auto unchanged = fty::asset::db::selectAssetElementWebById(room->id);
+            REQUIRE(unchanged);
+            CHECK(unchanged->typeId == room->typeId);
+            CHECK(unchanged->priority == room->priority);
+        }
+
+        // dry run checks the ids against the assets read with the names
+        {
+            std::string update = "name,type,sub_type,location,status,priority,id\n";
+            update += "Upd DC,datacenter,,,active,P2," + dc->name + "\n";
+            update += "Upd Room,row,,Upd DC,active,P3," + room->name;
+
+            auto validated = fty::asset::AssetManager::validateCsv(update, "dummy", false);
+            REQUIRE(validated);
+            REQUIRE(validated->size() == 2);
+            CHECK(validated->at(1));
+            CHECK(!validated->at(2));
+        }
+
+        deleteAsset(*room);
+        deleteAsset(*dc);
+    }
+
+    SECTION("Import of independent datacenters")
+    {
+        // rows of the datacenters are processed by different threads, RackB1 refers to a row which follows
+        static std::string data = R"(name,type,sub_type,location,status,priority,id
+DC A,datacenter,,,active,P1,
+DC B,datacenter,,,active,P1,
+DC C,datacenter,,,active,P1,
+RoomA1,room,,DC A,active,P1,
+RackB1,rack,,RowB1,active,P1,
+RoomB1,room,,DC B,active,P1,
+RoomC1,room,,DC C,active,P1,
+RowA1,row,,RoomA1,active,P1,
+RowB1,row,,RoomB1,active,P1,
+RowC1,row,,RoomC1,active,P1,
+RackA1,rack,,RowA1,active,P1,
+RackC1,rack,,RowC1,active,P1,
+RoomA2,room,,DC A,active,P1,)";
+
+        for (size_t chunk : {1, 64}) {
+            auto               cm = fty::asset::CsvMap_from_string(data);
+            fty::asset::Import import(cm);
+            import.setWorkers(4);
+            import.setChunkSize(chunk);
+            REQUIRE(import.process(false));
+
+            const auto& items = import.items();
+            REQUIRE(items.size() == 13);
+            for (const auto& [row, el] : items) {
+                CHECK(bool(el) == (row != 5));
+            }
+
+            // committed tree is the tree of the document
+            std::map<std::string, uint32_t> ids;
+            for (const auto& [row, el] : items) {
+                if (el) {
+                    ids[cm.get(row, "name")] = el->id;
+                }
+            }
+
+            tnt::Connection          conn;
+            fty::asset::db::Topology topology(conn);
+            for (const auto& [row, el] : items) {
+                if (!el) {
+                    continue;
+                }
+                auto node = topology.node(el->id);
+                REQUIRE(node);
+                CHECK(node->name == el->name);
+
+                auto location = cm.get(row, "location");
+                CHECK(node->parentId == (location.empty() ? 0 : ids.at(location)));
+            }
+            CHECK(topology.descendants(ids.at("DC A")).size() == 4);
+            CHECK(topology.descendants(ids.at("DC B")).size() == 2);
+            CHECK(topology.descendants(ids.at("DC C")).size() == 3);
+
+            for (auto iter = items.rbegin(); iter != items.rend(); ++iter) {
+                if (iter->second) {
+                    auto el = fty::asset::db::selectAssetElementWebById(iter->second->id);
+                    deleteAsset(*el);
+                }
+            }
+        }
+    }
+
+    SECTION("Import of datacenter rows sharing a power source")
+    {
+        static std::string shared = R"(name,type,sub_type,location,status,priority,id
+Shared DC,datacenter,,,active,P1,
+Shared PDU,device,epdu,Shared DC,active,P1,)";
+
+        auto setup = fty::asset::AssetManager::importCsv(shared, "dummy", false);
+        REQUIRE(setup);
+        REQUIRE(setup->size() == 2);
+        REQUIRE(setup->at(1));
+        REQUIRE(setup->at(2));
+        uint32_t pduId = *setup->at(2);
+
+        // every rack with its server is a group of rows, the groups are written concurrently and all of them refer to
+        // the same datacenter and power source
+        std::string data = "name,type,sub_type,location,status,priority,power_source.1,id\n";
+        for (int i = 1; i <= 8; ++i) {
+            auto n = std::to_string(i);
+            data += "Shared Rack" + n + ",rack,,Shared DC,active,P1,,\n";
+            data += "Shared Server" + n + ",device,server,Shared Rack" + n + ",active,P1,Shared PDU,\n";
+        }
+
+        for (size_t chunk : {1, 64}) {
+            auto               cm = fty::asset::CsvMap_from_string(data);
+            fty::asset::Import import(cm);
+            import.setWorkers(4);
+            import.setChunkSize(chunk);
+            REQUIRE(import.process(false));
+
+            const auto& items = import.items();
+            REQUIRE(items.size() == 16);
+            for (const auto& [row, el] : items) {
+                if (!el) {
+                    FAIL(el.error());
+                }
+            }
+
+            for (size_t row = 2; row <= items.size(); row += 2) {
+                auto links = fty::asset::db::selectAssetDeviceLinksTo(items.at(row)->id, 1);
+                REQUIRE(links);
+                REQUIRE(links->size() == 1);
+                CHECK((*links)[0].srcId == pduId);
+            }
+
+            for (auto iter = items.rbegin(); iter != items.rend(); ++iter) {
+                {
+                    tnt::Connection conn;
+                    REQUIRE(fty::asset::db::deleteAssetLinksTo(conn, iter->second->id));
+                }
+                auto el = fty::asset::db::selectAssetElementWebById(iter->second->id);
+                REQUIRE(el);
+                deleteAsset(*el);
+            }
+        }
+
+        for (auto iter = setup->rbegin(); iter != setup->rend(); ++iter) {
+            auto el = fty::asset::db::selectAssetElementWebById(*(iter->second));
+            REQUIRE(el);
+            deleteAsset(*el);
+        }
+    }
+
+    SECTION("Import job")
+    {
+        static std::string data = R"(name,type,sub_type,location,status,priority,id
+Job DC,datacenter,,,active,P1,
+Job Room,room,,Job DC,active,P1,
+Job Row,row,,Job Room,active,P1,)";
+
+        auto& jobs = fty::asset::ImportJobs::instance();
+        auto  id   = jobs.submit(std::string(data), "dummy", false);
+        REQUIRE(id);
+        CHECK(!jobs.status("unknown"));
+
+        std::optional<fty::asset::ImportJobs::Status> status;
+        for (int i = 0; i < 100; ++i) {
+            status = jobs.status(*id);
+            REQUIRE(status);
+            if (status->items) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        REQUIRE(status->items);
+        CHECK(status->state == fty::asset::ImportJobs::State::Finished);
+        CHECK(status->rowsDone == 3);
+        CHECK(status->rowsFailed == 0);
+        CHECK(!status->error);
+
+        for (auto iter = status->items->rbegin(); iter != status->items->rend(); ++iter) {
+            REQUIRE(iter->second);
+            auto el = fty::asset::db::selectAssetElementWebById(*(iter->second));
+            deleteAsset(*el);
+        }
+    }
+
+    SECTION("Dry run")
+    {
+        static std::string data = R"(name,type,sub_type,location,status,priority,id
+Dry DC,datacenter,,,active,P1,
+Dry Room,room,,Dry DC,active,P1,
+Dry Row,spaceship,,Dry Room,active,P1,
+Dry Rack,rack,,Dry Nowhere,active,P1,
+Dry DC,datacenter,,,active,P1,)";
+
+        auto ret = fty::asset::AssetManager::validateCsv(data, "dummy", false);
+        if (!ret) {
+            FAIL(ret.error());
+        }
+        REQUIRE(ret->size() == 5);
+        CHECK(ret->at(1));
+        CHECK(ret->at(2));
+        CHECK(!ret->at(3));
+        CHECK(!ret->at(4));
+        CHECK(!ret->at(5));
+
+        // nothing is written
+        CHECK(!fty::asset::db::selectAssetElementByName("Dry DC"));
+    }
 }
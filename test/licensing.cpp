@@ -0,0 +1,92 @@
+#include "asset/asset-licensing.h"
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Waits until the condition is met (the cache is refreshed by its own thread)
+template <typename Func>
+static bool eventually(Func&& condition)
+{
+    for (int i = 0; i < 100 && !condition(); ++i) {
+        std::this_thread::sleep_for(50ms);
+    }
+    return condition();
+}
+
+TEST_CASE("Licensing cache")
+{
+    std::atomic<int>  queries{0};
+    std::atomic<bool> failing{false};
+
+    auto query = [&]() -> fty::asset::AssetExpected<fty::asset::LimitationsStruct> {
+        int count = ++queries;
+        if (failing) {
+            return fty::unexpected("licensing is not available"_tr);
+        }
+        return fty::asset::LimitationsStruct{count, 1};
+    };
+
+    SECTION("cached limitations")
+    {
+        fty::asset::Licensing licensing(query, 1s);
+
+        // first call waits for the query
+        auto first = licensing.limitations();
+        REQUIRE(first);
+        CHECK(first->max_active_power_devices == 1);
+        CHECK(first->global_configurability == 1);
+
+        // next calls are served from the cache
+        CHECK(licensing.limitations()->max_active_power_devices == 1);
+        CHECK(queries == 1);
+
+        // invalidated limitations are queried again
+        licensing.invalidate();
+        CHECK(eventually([&]() {
+            return licensing.limitations()->max_active_power_devices == 2;
+        }));
+
+        // expired limitations are queried again without invalidation
+        CHECK(eventually([&]() {
+            return licensing.limitations()->max_active_power_devices == 3;
+        }));
+
+        // failed query keeps the cached limitations
+        failing = true;
+        int before = queries;
+        licensing.invalidate();
+        CHECK(eventually([&]() {
+            return queries > before;
+        }));
+        std::this_thread::sleep_for(100ms);
+        auto stale = licensing.limitations();
+        REQUIRE(stale);
+        CHECK(stale->max_active_power_devices == 3);
+
+        // announced limitations are applied at once
+        licensing.announced("rackcontroller-0", "power_nodes.max_active", "42");
+        CHECK(licensing.limitations()->max_active_power_devices == 42);
+        licensing.announced("rackcontroller-0", "configurability.global", "0");
+        CHECK(licensing.limitations()->global_configurability == 0);
+    }
+
+    SECTION("no limitations")
+    {
+        failing = true;
+        fty::asset::Licensing licensing(query, 1s);
+
+        auto ret = licensing.limitations();
+        CHECK(!ret);
+        CHECK(queries >= 1);
+    }
+
+    SECTION("cache disabled")
+    {
+        fty::asset::Licensing licensing(query, 0s);
+
+        CHECK(licensing.limitations()->max_active_power_devices == 1);
+        CHECK(licensing.limitations()->max_active_power_devices == 2);
+    }
+}
@@ -0,0 +1,129 @@
+#include "asset/asset-publisher.h"
+#include <catch2/catch.hpp>
+#include <czmq.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static zmsg_t* message(const std::string& body)
+{
+    zmsg_t* msg = zmsg_new();
+    zmsg_addstr(msg, body.c_str());
+    return msg;
+}
+
+TEST_CASE("Publisher")
+{
+    std::mutex               mutex;
+    std::vector<std::string> sent; // address/subject/body
+    bool                     failing = false;
+
+    auto send = [&](const std::string& address, const std::string& subject, zmsg_t** msg) {
+        char* body = zmsg_popstr(*msg);
+        zmsg_destroy(msg);
+
+        std::lock_guard lock(mutex);
+        sent.push_back(address + "/" + subject + "/" + (body ? body : ""));
+        zstr_free(&body);
+        return !failing;
+    };
+
+    auto sentCount = [&]() {
+        std::lock_guard lock(mutex);
+        return sent.size();
+    };
+
+    SECTION("flush")
+    {
+        fty::asset::Publisher publisher(send);
+
+        uint64_t last = 0;
+        for (int i = 0; i < 100; ++i) {
+            zmsg_t*  msg = message(std::to_string(i));
+            uint64_t seq = i % 2 ? publisher.sendTo("mailbox", "sendto", &msg) : publisher.publish("publish", &msg);
+            CHECK(msg == nullptr);
+            CHECK(seq > last);
+            last = seq;
+        }
+
+        // everything is sent in order of the calls
+        REQUIRE(publisher.flush(5s));
+        REQUIRE(sentCount() == 100);
+        for (int i = 0; i < 100; ++i) {
+            CHECK(sent[size_t(i)] == (i % 2 ? "mailbox/sendto/" : "/publish/") + std::to_string(i));
+        }
+    }
+
+    SECTION("several producers")
+    {
+        fty::asset::Publisher publisher(send);
+
+        // own messages of every producer are sent (assertions are not thread safe, they are checked later)
+        std::atomic<int>         waited{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                uint64_t seq = 0;
+                for (int i = 0; i < 50; ++i) {
+                    zmsg_t* msg = message(std::to_string(t) + "-" + std::to_string(i));
+                    seq         = publisher.publish("publish", &msg);
+                }
+                if (publisher.waitFor(seq, 5s)) {
+                    ++waited;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(waited == 4);
+
+        REQUIRE(publisher.flush(5s));
+        REQUIRE(sentCount() == 200);
+
+        // messages of every producer are sent in its order
+        std::map<std::string, int> next;
+        for (const auto& msg : sent) {
+            auto body     = msg.substr(msg.rfind('/') + 1);
+            auto producer = body.substr(0, body.find('-'));
+            CHECK(std::stoi(body.substr(body.find('-') + 1)) == next[producer]++);
+        }
+    }
+
+    SECTION("failed send")
+    {
+        failing = true;
+        fty::asset::Publisher publisher(send);
+
+        zmsg_t* msg = message("failed");
+        auto    seq = publisher.publish("publish", &msg);
+        CHECK(publisher.waitFor(seq, 5s));
+        CHECK(sentCount() == 1);
+    }
+
+    SECTION("stop")
+    {
+        fty::asset::Publisher publisher(send);
+
+        zmsg_t* msg = message("queued");
+        CHECK(publisher.publish("publish", &msg));
+
+        // queued messages are sent before the thread stops
+        publisher.stop();
+        CHECK(sentCount() == 1);
+
+        // nothing is accepted after stop
+        msg = message("late");
+        CHECK(publisher.publish("publish", &msg) == 0);
+        CHECK(msg == nullptr);
+        msg = message("late");
+        CHECK(publisher.sendTo("mailbox", "sendto", &msg) == 0);
+        CHECK(msg == nullptr);
+        CHECK(publisher.flush(1s));
+        CHECK(sentCount() == 1);
+    }
+}